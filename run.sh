@@ -56,10 +56,10 @@ DEST_DIR="$NS3_DIR/wifi-simulation"                       # Our WiFi example des
 echo "Creating destination directory: $DEST_DIR"
 mkdir -p "$DEST_DIR"
 
-# Copy all files from current directory except run.sh and .git to wifi-simulation
+# Copy all files from current directory except the driver scripts and .git to wifi-simulation
 echo "Copying WiFi simulation files..."
 for file in *; do
-    if [ "$file" != "run.sh" ] && [ "$file" != ".git" ] && [ -f "$file" ]; then
+    if [ "$file" != "run.sh" ] && [ "$file" != "sweep.sh" ] && [ "$file" != ".git" ] && [ -f "$file" ]; then
         cp "$file" "$DEST_DIR/"
         echo "  Copied: $file"
     fi
@@ -0,0 +1,169 @@
+#!/bin/bash
+#
+# Author: Ahmed Maksud; email: ahmed.maksud@email.ucr.edu
+# PI: Marcelo Menezes De Carvalho; email: mmcarvalho@txstate.edu
+# Texas State University
+#
+# WiFi Network Simulation Example - Parallel Sweep Script
+# =======================================================
+# This script runs many simulation/analysis pairs concurrently on one host:
+# 1. Read one sweep point per line from POINTS_FILE (extra arguments for
+#    wifi_analysis_and_control.py, e.g. "--ipc-mode batch --n-stas 64")
+# 2. Give every job its own ns3-ai shared memory names (--shm-prefix),
+#    RNG run number, output CSV and log file
+# 3. Pin every job to its own CPU cores with taskset
+# 4. Keep at most JOBS pairs running at a time
+#
+# The example must already be deployed and built (run ./run.sh once first).
+#
+# Usage: ./sweep.sh [-j JOBS] [-c CORES_PER_JOB] [-r BASE_RUN] [-o OUT_DIR] POINTS_FILE
+#   -j JOBS           concurrent simulation/analysis pairs (default: nproc / CORES_PER_JOB)
+#   -c CORES_PER_JOB  cores pinned to each pair (default: 2, one per process)
+#   -r BASE_RUN       RngRun of the first sweep point, incremented per point (default: 1)
+#   -o OUT_DIR        directory for CSVs, logs and the sweep index (default: sweep_results)
+
+set -e # Exit immediately if any command fails
+
+usage() {
+    echo "Usage: ./sweep.sh [-j JOBS] [-c CORES_PER_JOB] [-r BASE_RUN] [-o OUT_DIR] POINTS_FILE"
+    exit 1
+}
+
+# === COMMAND LINE OPTIONS ===
+NCPU=$(nproc)
+CORES_PER_JOB=2
+JOBS=""
+BASE_RUN=1
+OUT_DIR="sweep_results"
+while getopts "j:c:r:o:h" opt; do
+    case "$opt" in
+    j) JOBS="$OPTARG" ;;
+    c) CORES_PER_JOB="$OPTARG" ;;
+    r) BASE_RUN="$OPTARG" ;;
+    o) OUT_DIR="$OPTARG" ;;
+    *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+[[ $# -eq 1 && -f "$1" ]] || usage
+if [[ -z "$JOBS" ]]; then
+    JOBS=$((NCPU / CORES_PER_JOB))
+    [[ $JOBS -ge 1 ]] || JOBS=1
+fi
+
+echo "============================================"
+echo "WiFi Network Simulation Example - Sweep Run"
+echo "============================================"
+
+# === DIRECTORY VALIDATION ===
+# Same layout requirements as run.sh
+CURRENT_DIR="$(basename $(pwd))"
+if [[ ! "$CURRENT_DIR" == "NS3-first-WiFi-test" && ! "$CURRENT_DIR" == "NS3AI-first-WiFi-test" ]]; then
+    echo "Error: Please run this script from the NS3-first-WiFi-test directory"
+    echo "Current directory: $(pwd)"
+    exit 1
+fi
+
+EXAMPLE_DIR="../ns-allinone-3.44/ns-3.44/contrib/ai/examples/wifi-simulation"
+if [[ ! -f "$EXAMPLE_DIR/wifi_analysis_and_control.py" ]]; then
+    echo "Error: WiFi simulation example not found at $EXAMPLE_DIR"
+    echo "Please run ./run.sh once to deploy and build the example."
+    exit 1
+fi
+
+# Resolve paths before leaving this directory
+POINTS_FILE="$(realpath "$1")"
+mkdir -p "$OUT_DIR"
+OUT_DIR="$(realpath "$OUT_DIR")"
+
+# === ENVIRONMENT SETUP ===
+# Same virtual environment as run.sh
+if [[ -f "../NS3-NS3AI--installation-and-tests/venv_name.txt" ]]; then
+    VENV_NAME=$(cat ../NS3-NS3AI--installation-and-tests/venv_name.txt)
+else
+    VENV_NAME="EHRL"
+fi
+if [ ! -d "../$VENV_NAME" ]; then
+    echo "Error: Virtual environment '$VENV_NAME' not found at ../$VENV_NAME"
+    exit 1
+fi
+echo "Activating virtual environment: $VENV_NAME"
+source ../$VENV_NAME/bin/activate
+
+cd "$EXAMPLE_DIR"
+
+# === JOB SCHEDULING ===
+# SLOT_PIDS[s] is the job currently running in slot s; slot s owns cores
+# [s * CORES_PER_JOB, (s + 1) * CORES_PER_JOB) modulo the core count
+declare -a SLOT_PIDS
+FREE_SLOT=0
+
+find_free_slot() {
+    while true; do
+        for ((s = 0; s < JOBS; s++)); do
+            if [[ -z "${SLOT_PIDS[$s]}" ]] || ! kill -0 "${SLOT_PIDS[$s]}" 2>/dev/null; then
+                FREE_SLOT=$s
+                return
+            fi
+        done
+        wait -n || true # A job finished (its status is recorded in its .status file)
+    done
+}
+
+slot_cores() {
+    local first=$((($1 * CORES_PER_JOB) % NCPU))
+    local last=$((first + CORES_PER_JOB - 1))
+    [[ $last -lt $NCPU ]] || last=$((NCPU - 1))
+    echo "$first-$last"
+}
+
+echo "Running sweep points from $POINTS_FILE"
+echo "Concurrent jobs: $JOBS, cores per job: $CORES_PER_JOB, output: $OUT_DIR"
+echo "job,run,shm_prefix,csv,args" >"$OUT_DIR/sweep_index.csv"
+
+JOB=0
+while IFS= read -r line || [[ -n "$line" ]]; do
+    # Skip blank lines and comments
+    [[ -z "${line// /}" || "$line" =~ ^[[:space:]]*# ]] && continue
+    read -r -a POINT_ARGS <<<"$line"
+
+    RUN=$((BASE_RUN + JOB))
+    SHM_PREFIX="wifi$$_$JOB" # Unique per sweep invocation and job
+    CSV="$OUT_DIR/job_$JOB.csv"
+    LOG="$OUT_DIR/job_$JOB.log"
+
+    find_free_slot
+    CORES=$(slot_cores $FREE_SLOT)
+    echo "  Job $JOB (run $RUN, cores $CORES): $line"
+    echo "$JOB,$RUN,$SHM_PREFIX,$CSV,\"$line\"" >>"$OUT_DIR/sweep_index.csv"
+
+    # Sweep-point arguments come last so a point may override the run number
+    (
+        set +e
+        taskset -c "$CORES" python3 wifi_analysis_and_control.py \
+            --shm-prefix "$SHM_PREFIX" --csv "$CSV" --ns3-arg "run=$RUN" \
+            "${POINT_ARGS[@]}" >"$LOG" 2>&1
+        echo $? >"$OUT_DIR/job_$JOB.status"
+    ) &
+    SLOT_PIDS[$FREE_SLOT]=$!
+    JOB=$((JOB + 1))
+done <"$POINTS_FILE"
+
+wait
+
+# === SUMMARY ===
+FAILED=0
+for ((j = 0; j < JOB; j++)); do
+    STATUS=$(cat "$OUT_DIR/job_$j.status" 2>/dev/null || echo 1)
+    if [[ "$STATUS" != "0" ]]; then
+        echo "  Job $j failed (exit $STATUS), see $OUT_DIR/job_$j.log"
+        FAILED=$((FAILED + 1))
+    fi
+done
+
+echo ""
+echo "============================================"
+echo "Sweep completed: $JOB jobs, $FAILED failed"
+echo "Index: $OUT_DIR/sweep_index.csv"
+echo "============================================"
+[[ $FAILED -eq 0 ]]
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2025 Texas State University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+ * PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+ * Texas State University
+ */
+
+/**
+ * @file wifi_action_rate_manager.h
+ * @brief Remote station manager whose per-peer HT MCS is set by the controller
+ *
+ * ActionRateWifiManager behaves like ConstantRateWifiManager (DataMode for
+ * data frames, ControlMode for RTS/control frames, no feedback-driven
+ * adaptation) except that the data MCS can be overridden per peer address.
+ * GetReport() writes the per-STA MCS actions of the latest ActBatchStruct into
+ * the managers:
+ * - On an AP, the override for a STA's address selects the DL MCS to that STA
+ * - On a STA, SetDataMcs() selects the UL MCS (its only peer is the AP)
+ *
+ * Written against the WifiRemoteStationManager interface of ns-3.44.
+ */
+
+#ifndef WIFI_ACTION_RATE_MANAGER_H
+#define WIFI_ACTION_RATE_MANAGER_H
+
+#include "ns3/ht-phy.h"
+#include "ns3/mac48-address.h"
+#include "ns3/string.h"
+#include "ns3/wifi-mode.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/wifi-tx-vector.h"
+#include "ns3/wifi-utils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+
+/**
+ * @class ActionRateWifiManager
+ * @brief Constant-rate manager with per-peer HT MCS overrides
+ */
+class ActionRateWifiManager : public ns3::WifiRemoteStationManager
+{
+  public:
+    static ns3::TypeId GetTypeId()
+    {
+        static ns3::TypeId tid =
+            ns3::TypeId("ns3::ActionRateWifiManager")
+                .SetParent<ns3::WifiRemoteStationManager>()
+                .SetGroupName("Wifi")
+                .AddConstructor<ActionRateWifiManager>()
+                .AddAttribute("DataMode",
+                              "Mode of data frames to peers without an MCS override",
+                              ns3::StringValue("HtMcs1"),
+                              ns3::MakeWifiModeAccessor(&ActionRateWifiManager::m_dataMode),
+                              ns3::MakeWifiModeChecker())
+                .AddAttribute("ControlMode",
+                              "Mode of RTS and other control frames",
+                              ns3::StringValue("HtMcs0"),
+                              ns3::MakeWifiModeAccessor(&ActionRateWifiManager::m_ctlMode),
+                              ns3::MakeWifiModeChecker());
+        return tid;
+    }
+
+    /**
+     * Set the data MCS used towards one peer
+     * @param peer MAC address of the peer
+     * @param mcs HT MCS index (clamped to the single-stream MCS 0-7)
+     */
+    void SetPeerMcs(ns3::Mac48Address peer, uint8_t mcs)
+    {
+        m_peerModes[peer] = ns3::HtPhy::GetHtMcs(std::min<uint8_t>(mcs, 7));
+    }
+
+    /**
+     * Set the data MCS of every peer without an override
+     * @param mcs HT MCS index (clamped to the single-stream MCS 0-7)
+     */
+    void SetDataMcs(uint8_t mcs)
+    {
+        m_dataMode = ns3::HtPhy::GetHtMcs(std::min<uint8_t>(mcs, 7));
+    }
+
+    /**
+     * @param peer MAC address of the peer
+     * @return HT MCS index used towards the peer
+     */
+    uint8_t GetPeerMcs(ns3::Mac48Address peer) const
+    {
+        auto it = m_peerModes.find(peer);
+        return (it != m_peerModes.end() ? it->second : m_dataMode).GetMcsValue();
+    }
+
+  private:
+    ns3::WifiRemoteStation *DoCreateStation() const override
+    {
+        return new ns3::WifiRemoteStation();
+    }
+
+    void DoReportRxOk(ns3::WifiRemoteStation *, double, ns3::WifiMode) override
+    {
+    }
+
+    void DoReportRtsFailed(ns3::WifiRemoteStation *) override
+    {
+    }
+
+    void DoReportDataFailed(ns3::WifiRemoteStation *) override
+    {
+    }
+
+    void DoReportRtsOk(ns3::WifiRemoteStation *, double, ns3::WifiMode, double) override
+    {
+    }
+
+    void DoReportDataOk(ns3::WifiRemoteStation *,
+                        double,
+                        ns3::WifiMode,
+                        double,
+                        ns3::MHz_u,
+                        uint8_t) override
+    {
+    }
+
+    void DoReportFinalRtsFailed(ns3::WifiRemoteStation *) override
+    {
+    }
+
+    void DoReportFinalDataFailed(ns3::WifiRemoteStation *) override
+    {
+    }
+
+    ns3::WifiTxVector DoGetDataTxVector(ns3::WifiRemoteStation *station,
+                                        ns3::MHz_u allowedWidth) override
+    {
+        auto it = m_peerModes.find(station->m_state->m_address);
+        ns3::WifiMode mode = it != m_peerModes.end() ? it->second : m_dataMode;
+        uint8_t nss = 1 + mode.GetMcsValue() / 8;
+        return ns3::WifiTxVector(
+            mode,
+            GetDefaultTxPowerLevel(),
+            GetPreambleForTransmission(mode.GetModulationClass(), GetShortPreambleEnabled()),
+            ns3::GetGuardIntervalForMode(mode, GetPhy()->GetDevice()),
+            GetNumberOfAntennas(),
+            nss,
+            0,
+            GetPhy()->GetTxBandwidth(mode, std::min(allowedWidth, GetChannelWidth(station))),
+            GetAggregation(station));
+    }
+
+    ns3::WifiTxVector DoGetRtsTxVector(ns3::WifiRemoteStation *station) override
+    {
+        return ns3::WifiTxVector(
+            m_ctlMode,
+            GetDefaultTxPowerLevel(),
+            GetPreambleForTransmission(m_ctlMode.GetModulationClass(), GetShortPreambleEnabled()),
+            ns3::NanoSeconds(800),
+            1,
+            1,
+            0,
+            GetPhy()->GetTxBandwidth(m_ctlMode, GetChannelWidth(station)),
+            GetAggregation(station));
+    }
+
+    ns3::WifiMode m_dataMode; ///< Data mode of peers without an override
+    ns3::WifiMode m_ctlMode;  ///< Control mode
+    std::map<ns3::Mac48Address, ns3::WifiMode> m_peerModes; ///< Per-peer data mode overrides
+};
+
+#endif // WIFI_ACTION_RATE_MANAGER_H
@@ -36,30 +36,200 @@ Key Features:
 """
 
 # Data analysis and processing libraries
-import pandas as pd
+import numpy as np
 
 # Import the compiled Python binding module (created from wifi_python_bindings.cc)
 import ns3ai_wifi_py as py_binding
+from wifi_online_stats import OnlineStats
+from wifi_recorder import ColumnarRecorder
 
 # Standard library imports for system operations and error handling
+import argparse
+import logging
 import sys
 import traceback
 import os
+import types
 
 # Import NS3-AI utilities for experiment management
 from ns3ai_utils import Experiment
 
-print("python: WiFi Network Simulation - Python Analysis Started")
+# === COMMAND LINE OPTIONS ===
+"""
+Select how WiFi data is exchanged with the C++ simulation:
+- per-sta: one shared-memory round trip per STA record (original behaviour)
+- batch: one round trip per report carrying all STA records (EnvBatchStruct)
+- vector: one round trip per --queue-depth reports through the ns3-ai vector
+  channel, letting the simulation run ahead of Python by a bounded amount
+- async: batched exchange driven by a C++ worker thread; the simulation never
+  waits for Python and applies each reply --action-latency reports later
+- ring: lock-free shared-memory rings outside ns3-ai; the simulation publishes
+  every report without a round trip and applies the newest action at its next
+  report (other readers, e.g. a dashboard, can observe the same telemetry)
+"""
+parser = argparse.ArgumentParser(description="WiFi NS3-AI analysis and control")
+parser.add_argument(
+    "--ipc-mode",
+    choices=["per-sta", "batch", "vector", "async", "ring"],
+    default="per-sta",
+    help="C++/Python exchange mode (default: per-sta)",
+)
+parser.add_argument(
+    "--wire-format",
+    choices=["full", "compact"],
+    default="full",
+    help="batch mode records: full (EnvBatchStruct) or compact (per-AP fields once per "
+    "report, float32 per-STA values), passed as --wireFormat (default: full)",
+)
+parser.add_argument(
+    "--queue-depth",
+    type=int,
+    default=4,
+    help="reports buffered per exchange in vector mode (default: 4)",
+)
+parser.add_argument(
+    "--action-latency",
+    type=int,
+    default=1,
+    help="reports before a reply is applied in async mode (default: 1)",
+)
+parser.add_argument(
+    "--controller",
+    choices=["python", "linear", "hysteresis", "pid"],
+    default="python",
+    help="AP Tx policy: python (this script) or a native C++ controller, in which "
+    "case the replies sent from here are ignored (default: python)",
+)
+parser.add_argument(
+    "--n-stas",
+    type=int,
+    default=8,
+    help="number of STAs, passed to the simulation as --nStas (default: 8)",
+)
+parser.add_argument(
+    "--n-aps",
+    type=int,
+    default=1,
+    help="number of APs (one BSS each), passed to the simulation as --nAps; with more than "
+    "one AP the batch and vector loops set every AP's Tx power from its own BSS (default: 1)",
+)
+parser.add_argument(
+    "--flow-monitor",
+    action="store_true",
+    help="install FlowMonitor in the simulation and record per-STA DL/UL delay, jitter "
+    "and loss (passed as --flowMonitor)",
+)
+parser.add_argument(
+    "--rate-manager",
+    choices=["constant", "action", "minstrel", "ideal"],
+    default="constant",
+    help="rate control of the simulation (passed as --rateManager); with action the batch, "
+    "async and ring loops set every STA's MCS from its measured SNR (default: constant)",
+)
+parser.add_argument(
+    "--ns3-arg",
+    action="append",
+    default=[],
+    metavar="KEY=VALUE",
+    help="extra ScenarioConfig option for the simulation, e.g. --ns3-arg interval=0.1 "
+    "(repeatable)",
+)
+parser.add_argument(
+    "--shm-prefix",
+    default="My",
+    help="prefix of the ns3-ai shared memory names; every concurrent simulation/analysis "
+    "pair needs its own (default: My, the ns3-ai default names)",
+)
+parser.add_argument(
+    "--csv",
+    default=None,
+    help="output path; a .parquet or .arrow extension streams Parquet / Arrow IPC instead of "
+    "CSV (default: toy_data.<--format extension> next to this script)",
+)
+parser.add_argument(
+    "--format",
+    choices=["csv", "parquet", "arrow"],
+    default="csv",
+    help="format of the default output file; parquet and arrow need pyarrow (default: csv)",
+)
+parser.add_argument(
+    "--chunk-rows",
+    type=int,
+    default=65536,
+    help="records buffered in memory before they are appended to the CSV (default: 65536)",
+)
+parser.add_argument(
+    "--verbosity",
+    type=int,
+    choices=[0, 1, 2, 3],
+    default=1,
+    help="console output on both sides: 0 quiet, 1 per-report summary, 2 per-STA "
+    "records, 3 per-message IPC traces; passed to the simulation as --verbosity (default: 1)",
+)
+args = parser.parse_args()
+if args.wire_format == "compact" and args.ipc_mode != "batch":
+    parser.error("--wire-format compact needs --ipc-mode batch")
+if args.chunk_rows < 1:
+    parser.error("--chunk-rows must be at least 1")
+if args.rate_manager == "action" and args.ipc_mode not in ("batch", "async", "ring"):
+    parser.error("--rate-manager action needs per-STA actions: --ipc-mode batch, async or ring")
+
+# === LOGGING ===
+"""
+Leveled console output, mirroring --verbosity of the simulation:
+- INFO: start/end messages and one summary line per report
+- DEBUG: one line per STA record
+- TRACE: every shared-memory handshake step
+Messages use lazy %-formatting, so disabled levels cost a single level check.
+"""
+TRACE = 5
+logging.addLevelName(TRACE, "TRACE")
+logging.basicConfig(
+    format="python: %(message)s",
+    level={0: logging.WARNING, 1: logging.INFO, 2: logging.DEBUG, 3: TRACE}[args.verbosity],
+    stream=sys.stdout,
+)
+log = logging.getLogger("wifi_analysis_and_control")
+log.info("WiFi Network Simulation - Python Analysis Started")
+
+# Async mode uses the batched structures; only the C++ side behaves differently
+BATCHED = args.ipc_mode in ("batch", "async")
+
+# Number of STAs and APs in the simulation (ScenarioConfig::nStas and nAps)
+N_STAS = args.n_stas
+N_APS = args.n_aps
+if not 1 <= N_APS <= py_binding.MAX_APS:
+    parser.error(f"--n-aps must be between 1 and {py_binding.MAX_APS}")
+
+# Vector mode: one slot per STA record of every buffered report
+VECTOR_SIZE = args.queue_depth * N_STAS
+
+# Shared memory size from the structure sizes reported by the bindings, plus 4 KiB
+# of ns3-ai bookkeeping; in vector mode both vectors need VECTOR_SIZE slots. Only the
+# batched modes carry per-STA actions (ActBatchStruct)
+COMPACT = args.wire_format == "compact"
+if COMPACT:
+    SHM_SIZE = 4096 + 2 * (py_binding.COMPACT_STRUCT_SIZE + py_binding.ACT_BATCH_STRUCT_SIZE)
+elif BATCHED:
+    SHM_SIZE = 4096 + 2 * (py_binding.BATCH_STRUCT_SIZE + py_binding.ACT_BATCH_STRUCT_SIZE)
+elif args.ipc_mode == "vector":
+    SHM_SIZE = 4096 + 2 * VECTOR_SIZE * (py_binding.ENV_STRUCT_SIZE + py_binding.ACT_STRUCT_SIZE)
+else:
+    # per-sta; in ring mode the ns3-ai segment is still created but never used
+    SHM_SIZE = 4096 + 2 * (py_binding.ENV_STRUCT_SIZE + py_binding.ACT_STRUCT_SIZE)
 
 # === FILE SYSTEM SETUP ===
 """
 Setup data export path for simulation results:
 - Get the current script directory for relative file paths
-- Create CSV file path for exporting network performance data
+- Create the output path (CSV, Parquet or Arrow IPC) for network performance data
 - Ensures data is saved in the same directory as the script
 """
 script_dir = os.path.dirname(os.path.abspath(__file__))
-csv_path = os.path.join(script_dir, "toy_data.csv")
+# Resolved now: Experiment() changes the working directory to the ns-3 root
+csv_path = (
+    os.path.abspath(args.csv) if args.csv else os.path.join(script_dir, f"toy_data.{args.format}")
+)
 
 # === EXPERIMENT INITIALIZATION ===
 """
@@ -68,141 +238,412 @@ Create an Experiment object to manage NS3-Python WiFi simulation communication:
 - ".": Working directory relative to examples directory
 - py_binding: Our compiled Python binding module for WiFi data structures
 - handleFinish=True: Automatically handle simulation finish signals
+In batch and async modes the binding module is wrapped so that ns3ai_utils constructs the
+batched interface (Ns3AiBatchMsgInterfaceImpl, or Ns3AiCompactMsgInterfaceImpl for the compact
+wire format) instead of the per-STA one.
 """
-exp = Experiment("ns3ai_wifi_simulation", "../../../../", py_binding, handleFinish=True)
-print("python: Calling the NS3 WiFi simulation script")
+if COMPACT:
+    msg_module = types.SimpleNamespace(
+        Ns3AiMsgInterfaceImpl=py_binding.Ns3AiCompactMsgInterfaceImpl
+    )
+elif BATCHED:
+    msg_module = types.SimpleNamespace(
+        Ns3AiMsgInterfaceImpl=py_binding.Ns3AiBatchMsgInterfaceImpl
+    )
+else:
+    msg_module = py_binding
+exp = Experiment(
+    "ns3ai_wifi_simulation",
+    "../../../../",
+    msg_module,
+    handleFinish=True,
+    useVector=args.ipc_mode == "vector",
+    vectorSize=VECTOR_SIZE if args.ipc_mode == "vector" else None,
+    shmSize=SHM_SIZE,
+    segName=f"{args.shm_prefix} Seg",
+    cpp2pyMsgName=f"{args.shm_prefix} Cpp to Python Msg",
+    py2cppMsgName=f"{args.shm_prefix} Python to Cpp Msg",
+    lockableName=f"{args.shm_prefix} Lockable",
+)
+log.info("Calling the NS3 WiFi simulation script")
 
 # Start the NS3 WiFi simulation and get the message interface
-msgInterface = exp.run(show_output=True)
+sim_settings = {
+    "nStas": N_STAS,
+    "nAps": N_APS,
+    "ipcMode": args.ipc_mode,
+    "wireFormat": args.wire_format,
+    "queueDepth": args.queue_depth,
+    "actionLatency": args.action_latency,
+    "controller": args.controller,
+    "shmPrefix": args.shm_prefix,
+    "verbosity": args.verbosity,
+    "flowMonitor": int(args.flow_monitor),
+    "rateManager": args.rate_manager,
+}
+for ns3_arg in args.ns3_arg:
+    key, _, value = ns3_arg.partition("=")
+    sim_settings[key] = value
+msgInterface = exp.run(setting=sim_settings, show_output=True)
 
 # === DATA COLLECTION SETUP ===
 """
 Initialize data structures for network performance analysis:
-- data_store: List to accumulate all WiFi network measurements
-- prev_now_sec: Track simulation time for change detection
-- current_dl_values: Buffer for current downlink throughput values
-- prev_mean_dl: Previous mean downlink throughput for comparison
+- recorder: Columnar buffer of all WiFi network measurements, flushed to the CSV
+  every --chunk-rows records (see wifi_recorder.py)
+- stats: Streaming per-STA, per-BSS and per-interval statistics (see
+  wifi_online_stats.py); the AP Tx decisions use the means of the last
+  complete interval
 """
-data_store = []  # Master data collection list
-prev_now_sec = -1.0  # Previous simulation timestamp
-current_dl_values = []  # Current downlink throughput buffer
-prev_mean_dl = None  # Previous mean downlink for adaptive control
+# CSV row: the EnvStruct fields with set_ApTx (the Tx power chosen for the record's AP)
+# after now_sec
+ROW_DTYPE = np.dtype(
+    [
+        *((name, py_binding.ENV_DTYPE[name]) for name in py_binding.ENV_DTYPE.names[:9]),
+        ("set_ApTx", np.float64),
+        *((name, py_binding.ENV_DTYPE[name]) for name in py_binding.ENV_DTYPE.names[9:]),
+    ]
+)
+recorder = ColumnarRecorder(csv_path, ROW_DTYPE, args.chunk_rows)  # Master data collection
+stats = OnlineStats(N_STAS, N_APS, py_binding.ENV_DTYPE)  # Interval means, variances, quantiles
+
+# Per-STA MCS actions (batch, async and ring loops with --rate-manager action)
+STA_MCS = args.rate_manager == "action"
+if STA_MCS and N_STAS > py_binding.PyActBatchStruct.sta_capacity:
+    parser.error(
+        f"--rate-manager action supports at most {py_binding.PyActBatchStruct.sta_capacity} STAs"
+    )
+# Minimum SNR (dB) of HT MCS 0-7 on a 20 MHz single-stream link, with some margin
+MCS_MIN_SNR = np.array([2.0, 5.0, 9.0, 11.0, 15.0, 18.0, 20.0, 25.0])
+
+
+# === ADAPTIVE CONTROL ALGORITHM ===
+def adaptive_ap_tx(mean_dl):
+    """
+    Compute the new AP transmission power from the mean downlink throughput
+    of the previous report interval (None before the first complete interval).
+    Example adaptive algorithm:
+    Higher throughput -> reduce power (less interference)
+    Lower throughput -> maintain/increase power
+    """
+    if mean_dl is None:
+        return 20.0  # Default transmission power (dBm)
+    return max(1.0, min(30.0, 30.0 - 30.0 * mean_dl / 100.0))
+
+
+def bss_ap_tx():
+    """
+    Tx power of every AP (array indexed by AP id) from the mean DL of its BSS in the
+    last complete interval: adaptive_ap_tx() applied to all BSSs at once
+    """
+    mean_dl = stats.bss_mean_dl
+    return np.where(np.isnan(mean_dl), 20.0, np.clip(30.0 - 30.0 * mean_dl / 100.0, 1.0, 30.0))
+
+
+def decide_ap_tx(report):
+    """
+    Per-AP decision for one report (ENV_DTYPE array): Tx powers from the previous mean
+    DL of each BSS, then add this report to the statistics
+    """
+    decisions = bss_ap_tx()
+    stats.add_report(report)
+    return decisions
+
+
+def decide_sta_mcs(report):
+    """
+    Per-STA MCS for one report (ENV_DTYPE array): (sta_ids, MCS) with the highest MCS
+    whose minimum SNR the STA's mean SNR reaches; STAs without decoded frames
+    (snr == 0) keep their MCS
+    """
+    snr = report["snr"]
+    mcs = np.maximum(np.searchsorted(MCS_MIN_SNR, snr, side="right") - 1, 0)
+    return report["sta_id"], np.where(snr != 0.0, mcs, py_binding.MCS_KEEP)
+
+
+def write_action(act, decisions, sta_mcs=None):
+    """
+    Write per-AP decisions into a PyActStruct or PyActBatchStruct (a single AP only
+    uses set_ApTx), plus the per-STA (sta_ids, MCS) decisions if given (PyActBatchStruct
+    only; the STA Tx powers are left unchanged)
+    """
+    act.set_ApTx = decisions[0]
+    if N_APS > 1:
+        act.count = N_APS
+        act.ap_tx[:N_APS] = decisions
+    else:
+        act.count = 0
+    if sta_mcs is not None:
+        # Fill the per-STA arrays through their NumPy views (no per-entry calls)
+        sta_ids, mcs = sta_mcs
+        act.sta_count = N_STAS
+        act.sta_mcs[:N_STAS] = py_binding.MCS_KEEP
+        act.sta_mcs[sta_ids] = mcs
+        act.sta_tx_power[:N_STAS] = np.nan
+    elif isinstance(act, py_binding.PyActBatchStruct):
+        act.sta_count = 0
+
+
+def expand_compact(batch):
+    """
+    ENV_DTYPE records of a compact report (PyCompactBatchStruct), copied out of shared
+    memory; the per-AP fields are looked up by ap_id and the distance follows from the
+    positions. Raises if the simulation was built with another compact layout.
+    """
+    layout = (batch.version, batch.ap_record_size, batch.sta_record_size)
+    expected = (
+        py_binding.COMPACT_VERSION,
+        py_binding.COMPACT_AP_DTYPE.itemsize,
+        py_binding.COMPACT_STA_DTYPE.itemsize,
+    )
+    if layout != expected:
+        raise RuntimeError(f"compact layout {layout} of the simulation, bindings expect {expected}")
+    stas = batch.stas_array()
+    aps = batch.aps_array()[stas["ap_id"]]
+    records = np.empty(len(stas), dtype=py_binding.ENV_DTYPE)
+    for name in stas.dtype.names:
+        records[name] = stas[name]
+    records["distance"] = np.hypot(stas["pos_x"] - aps["pos_x"], stas["pos_y"] - aps["pos_y"])
+    records["ul_tp"] = aps["ul_tp"]
+    records["get_ApTx"] = aps["tx_power"]
+    records["ap_rx_drops"] = aps["rx_drops"]
+    records["now_sec"] = batch.now_sec
+    return records
+
+
+def store_report(report, decisions):
+    """Append the records of one report (ENV_DTYPE array) with the Tx power chosen for their AP"""
+    set_ApTx = decisions[report["ap_id"]]
+    if log.isEnabledFor(logging.DEBUG):
+        for record, tx in zip(report, set_ApTx):
+            log.debug(
+                "WiFi Status - time=%.5f STA_ID=%d AP_ID=%d Distance=%.5fm DL=%.5fMbps "
+                "new_Tx=%.5fdBm",
+                record["now_sec"],
+                record["sta_id"],
+                record["ap_id"],
+                record["distance"],
+                record["dl_tp"],
+                tx,
+            )
+    recorder.append(report, set_ApTx=set_ApTx)
+
+
+# === PER-STA COMMUNICATION LOOP ===
+def run_per_sta_loop():
+    """One shared-memory round trip per STA record (EnvStruct)"""
+    # Reply of every record of the current interval, decided once per interval
+    set_ApTx = adaptive_ap_tx(None)
 
-# === MAIN COMMUNICATION AND ANALYSIS LOOP ===
-try:
     while True:
-        print("python: Starting WiFi data reception...")
+        log.log(TRACE, "Starting WiFi data reception...")
 
         # === RECEIVE PHASE: Get WiFi network data from C++ ===
         msgInterface.PyRecvBegin()  # Lock shared memory and wait for C++ data
 
         # Check if WiFi simulation has finished
-        print("python: WiFi simulation status:", msgInterface.PyGetFinished())
+        log.log(TRACE, "WiFi simulation status: %s", msgInterface.PyGetFinished())
         if msgInterface.PyGetFinished():
             break  # Exit loop when C++ simulation is complete
 
         # === READ WIFI NETWORK DATA ===
         """
-        Extract current WiFi network state from shared memory:
+        Copy the current WiFi network state out of shared memory in one call:
         - Station position coordinates (pos_x, pos_y)
         - Network performance metrics (dl_tp, ul_tp)
         - Distance from station to access point
         - Current transmission parameters (get_ApTx)
-        - Station ID and simulation timestamp
+        - Station ID, serving AP and simulation timestamp
+        - Flow and PHY statistics
         """
-        wifi_data = msgInterface.GetCpp2PyStruct()
-
-        # Extract individual WiFi network parameters
-        pos_x = wifi_data.pos_x  # Station X position (meters)
-        pos_y = wifi_data.pos_y  # Station Y position (meters)
-        distance = wifi_data.distance  # Distance to AP (meters)
-        dl_tp = wifi_data.dl_tp  # Downlink throughput (Mbps)
-        ul_tp = wifi_data.ul_tp  # Uplink throughput (Mbps)
-        get_ApTx = wifi_data.get_ApTx  # Current AP transmission parameter
-        sta_id = wifi_data.sta_id  # Station identifier
-        now_sec = wifi_data.now_sec  # Current simulation time
+        record = msgInterface.GetCpp2PyStruct().as_array().copy()
 
         msgInterface.PyRecvEnd()  # Unlock shared memory, signal C++ we're done reading
-        print("python: WiFi data received successfully.")
-
-        # === DATA PROCESSING AND ANALYSIS ===
-        """
-        Process WiFi network data for analysis and control decisions:
-        - Collect data points for CSV export
-        - Calculate network performance statistics
-        - Implement adaptive transmission control algorithms
-        """
+        log.log(TRACE, "WiFi data received successfully.")
 
         # === ADAPTIVE CONTROL ALGORITHM ===
         """
         Implement adaptive transmission control based on network performance:
-        - Monitor throughput changes over time periods
-        - Calculate mean throughput for stability
-        - Adjust AP transmission parameters for optimization
+        - Feed every record into the online statistics (see wifi_online_stats.py)
+        - An interval is complete once its last STA record has arrived
+        - The Tx power is decided once per interval, from the mean DL throughput
+          of the previous complete interval
         - Example: reduce power when throughput is high (less interference)
         """
-
-        # Initialize control parameter with current value
-        set_ApTx = 20.0  # Default transmission power (dBm)
-
-        # Time-based analysis for adaptive control
-        if now_sec != prev_now_sec:
-            # Calculate mean DL throughput for previous timestamp period
-            if current_dl_values:
-                prev_mean_dl = sum(current_dl_values) / len(current_dl_values)
-                print(f"python: Mean DL @ {prev_now_sec:.2f}s: {prev_mean_dl:.2f} Mbps")
-
-            # Reset for new timestamp period
-            prev_now_sec = now_sec
-            current_dl_values = []
-
-        # Accumulate current measurement
-        current_dl_values.append(dl_tp)
-
-        # Adaptive transmission power control based on historical performance
-        if prev_mean_dl is not None:
-            # Example adaptive algorithm:
-            # Higher throughput -> reduce power (less interference)
-            # Lower throughput -> maintain/increase power
-            set_ApTx = max(1.0, min(30.0, 30.0 - 30.0 * prev_mean_dl / 100.0))
-            print(f"python: Adaptive control - ApTx set to: {set_ApTx:.2f} dBm")
+        summary = stats.add_record(record)
 
         # === COMPREHENSIVE DATA LOGGING ===
-        print(
-            f"python: WiFi Status - "
-            f"time={now_sec:.5f} "
-            f"STA_ID={sta_id} "
-            f"Position=({pos_x:.5f},{pos_y:.5f}) "
-            f"Distance={distance:.5f}m "
-            f"DL={dl_tp:.5f}Mbps "
-            f"UL={ul_tp:.5f}Mbps "
-            f"old_Tx={get_ApTx:.5f}dBm "
-            f"new_Tx={set_ApTx:.5f}dBm"
-        )
+        if log.isEnabledFor(logging.DEBUG):
+            fields = record[0]
+            log.debug(
+                "WiFi Status - time=%.5f STA_ID=%d Position=(%.5f,%.5f) Distance=%.5fm "
+                "DL=%.5fMbps UL=%.5fMbps old_Tx=%.5fdBm new_Tx=%.5fdBm",
+                fields["now_sec"],
+                fields["sta_id"],
+                fields["pos_x"],
+                fields["pos_y"],
+                fields["distance"],
+                fields["dl_tp"],
+                fields["ul_tp"],
+                fields["get_ApTx"],
+                set_ApTx,
+            )
 
         # Store comprehensive WiFi measurement data for analysis
-        data_point = {
-            "pos_x": pos_x,
-            "pos_y": pos_y,
-            "distance": distance,
-            "dl_tp": dl_tp,
-            "ul_tp": ul_tp,
-            "get_ApTx": get_ApTx,
-            "sta_id": sta_id,
-            "now_sec": now_sec,
-            "set_ApTx": set_ApTx,
-        }
-        data_store.append(data_point)
+        recorder.append(record, set_ApTx=set_ApTx)
 
         # === SEND PHASE: Return control commands to C++ ===
-        print("python: Sending adaptive control commands...")
+        log.log(TRACE, "Sending adaptive control commands...")
         msgInterface.PySendBegin()  # Lock shared memory for writing control commands
 
         # Write the calculated control parameters to shared memory
+        # (one rule for all APs: every reply sets every AP)
         msgInterface.GetPy2CppStruct().set_ApTx = set_ApTx
 
         msgInterface.PySendEnd()  # Unlock shared memory, signal C++ that commands are ready
-        print("python: Control commands sent successfully.")
+        log.log(TRACE, "Control commands sent successfully.")
+
+        # The interval is complete: decide the replies of the next one
+        if summary is not None:
+            set_ApTx = adaptive_ap_tx(summary.mean_dl)
+            log.info("Mean DL @ %.2fs: %.2f Mbps", summary.now_sec, summary.mean_dl)
+            log.log(TRACE, "Adaptive control - ApTx set to: %.2f dBm", set_ApTx)
+
+
+# === BATCHED COMMUNICATION LOOP ===
+def run_batch_loop():
+    """One shared-memory round trip per report carrying every STA (EnvBatchStruct)"""
+    while True:
+        log.log(TRACE, "Starting WiFi batch reception...")
+
+        # === RECEIVE PHASE: Get the whole report from C++ ===
+        msgInterface.PyRecvBegin()
+        if msgInterface.PyGetFinished():
+            break
+
+        # One NumPy view over the valid records, copied out of shared memory before PyRecvEnd
+        # (compact reports are expanded to the same ENV_DTYPE records)
+        if COMPACT:
+            records = expand_compact(msgInterface.GetCpp2PyStruct())
+        else:
+            records = msgInterface.GetCpp2PyStruct().as_array().copy()
+
+        msgInterface.PyRecvEnd()
+        log.log(TRACE, "WiFi batch of %d records received successfully.", len(records))
+
+        # Same decision the per-STA loop applies at the end of a report:
+        # based on the mean DL throughput of the previous report (per BSS)
+        decisions = decide_ap_tx(records)
+        store_report(records, decisions)
+
+        if len(records):
+            log.info(
+                "Mean DL @ %.2fs: %.2f Mbps, ApTx set to: %.2f dBm",
+                records["now_sec"][0],
+                stats.mean_dl,
+                decisions[0],
+            )
+
+        # === SEND PHASE: Return the control command for this report ===
+        msgInterface.PySendBegin()
+        write_action(
+            msgInterface.GetPy2CppStruct(),
+            decisions,
+            decide_sta_mcs(records) if STA_MCS else None,
+        )
+        msgInterface.PySendEnd()
+        log.log(TRACE, "Control commands sent successfully.")
+
+
+# === VECTOR COMMUNICATION LOOP ===
+def run_vector_loop():
+    """One shared-memory round trip per window of several reports (vector channel)"""
+    while True:
+        log.log(TRACE, "Starting WiFi vector reception...")
+
+        # === RECEIVE PHASE: Get up to queue_depth reports from C++ ===
+        msgInterface.PyRecvBegin()
+        if msgInterface.PyGetFinished():
+            break
+
+        # Copy the valid records out of shared memory (sta_id < 0 marks unused slots);
+        # the boolean mask on the NumPy view copies every valid record in one call
+        view = msgInterface.GetCpp2PyVector().as_array()
+        records = view[view["sta_id"] >= 0]
+
+        msgInterface.PyRecvEnd()
+        log.log(TRACE, "WiFi vector of %d records received successfully.", len(records))
+
+        # Replay the window report by report with the same per-report decision rule
+        decisions = bss_ap_tx()
+        for start in range(0, len(records), N_STAS):
+            report = records[start : start + N_STAS]
+            decisions = decide_ap_tx(report)
+            store_report(report, decisions)
+            log.info(
+                "Mean DL @ %.2fs: %.2f Mbps, ApTx set to: %.2f dBm",
+                report["now_sec"][0],
+                stats.mean_dl,
+                decisions[0],
+            )
+
+        # === SEND PHASE: C++ applies the decision of the latest report (slot 0) ===
+        msgInterface.PySendBegin()
+        write_action(msgInterface.GetPy2CppVector()[0], decisions)
+        msgInterface.PySendEnd()
+        log.log(TRACE, "Control commands sent successfully.")
+
+
+# === SHARED-MEMORY RING LOOP ===
+def run_ring_loop():
+    """Telemetry and actions through the lock-free rings (no ns3-ai handshake)"""
+    # Created by the simulation once it has parsed its options
+    ring = py_binding.ShmRing(f"/{args.shm_prefix}WifiRing", reader=0, timeout=60.0)
+    act = py_binding.PyActBatchStruct()
+    partial = np.empty(0, dtype=py_binding.ENV_DTYPE)  # Start of a report split by the ring end
+
+    while not ring.closed:
+        # Ready records, possibly several reports; copied out before the slots are released
+        view = ring.poll(timeout=0.1)
+        if len(view) == 0:
+            continue
+        records = np.concatenate((partial, view))
+        ring.release()
+        log.log(TRACE, "WiFi ring delivered %d records.", len(view))
+
+        # Every report carries N_STAS records; keep an incomplete one for the next poll
+        complete = len(records) // N_STAS * N_STAS
+        partial = records[complete:]
+        if complete == 0:
+            continue
+        for start in range(0, complete, N_STAS):
+            report = records[start : start + N_STAS]
+            decisions = decide_ap_tx(report)
+            store_report(report, decisions)
+            log.info(
+                "Mean DL @ %.2fs: %.2f Mbps, ApTx set to: %.2f dBm",
+                report["now_sec"][0],
+                stats.mean_dl,
+                decisions[0],
+            )
+
+        # One action for the newest report; the simulation applies it at its next report
+        write_action(act, decisions, decide_sta_mcs(report) if STA_MCS else None)
+        if not ring.write_action(act):
+            break
+        log.log(TRACE, "Control commands sent successfully.")
+
+
+# === MAIN COMMUNICATION AND ANALYSIS LOOP ===
+try:
+    if BATCHED:
+        run_batch_loop()
+    elif args.ipc_mode == "vector":
+        run_vector_loop()
+    elif args.ipc_mode == "ring":
+        run_ring_loop()
+    else:
+        run_per_sta_loop()
 
 # === ERROR HANDLING ===
 except Exception as e:
@@ -213,16 +654,13 @@ except Exception as e:
     - Ensures clean exit and data preservation on errors
     """
     exc_type, exc_value, exc_traceback = sys.exc_info()
-    print("python: Exception occurred in WiFi simulation: {}".format(e))
-    print("python: Traceback:")
+    log.error("Exception occurred in WiFi simulation: %s", e)
+    log.error("Traceback:")
     traceback.print_tb(exc_traceback)
 
-    # Save collected data even if error occurs
-    if data_store:
-        print("python: Saving collected WiFi data before exit...")
-        df = pd.DataFrame(data_store)
-        df.to_csv(csv_path, index=False)
-        print(f"python: WiFi data saved to {csv_path}")
+    # Earlier chunks are already on disk; the buffered records are flushed below
+    if len(recorder):
+        log.warning("Saving collected WiFi data before exit...")
 
     exit(1)
 
@@ -234,7 +672,7 @@ else:
     - Provide summary statistics
     - Prepare data for visualization
     """
-    print("python: WiFi simulation completed successfully.")
+    log.info("WiFi simulation completed successfully.")
 
 # === CLEANUP AND DATA EXPORT ===
 finally:
@@ -245,29 +683,49 @@ finally:
     - Exports collected data to CSV for analysis
     - Provides final status and statistics
     """
-    print("python: Cleaning up WiFi simulation resources...")
-
-    # Export collected data to CSV for analysis and visualization
-    if data_store:
-        df = pd.DataFrame(data_store)
-        df.to_csv(csv_path, index=False)
-        print(f"python: WiFi network data exported to {csv_path}")
-        print(f"python: Total data points collected: {len(data_store)}")
-
-        # Provide summary statistics if data was collected
-        if len(data_store) > 0:
-            print(
-                f"python: Simulation duration: {max(df['now_sec']) - min(df['now_sec']):.2f} seconds"
-            )
-            print(
-                f"python: Average throughput: DL={df['dl_tp'].mean():.2f} Mbps, UL={df['ul_tp'].mean():.2f} Mbps"
-            )
-            print(
-                f"python: Distance range: {df['distance'].min():.2f}m - {df['distance'].max():.2f}m"
+    log.info("Cleaning up WiFi simulation resources...")
+
+    # Append the last buffered records to the CSV for analysis and visualization
+    recorder.close()
+    if len(recorder):
+        summary = recorder.summary()
+        log.info("WiFi network data exported to %s", csv_path)
+        log.info("Total data points collected: %d", summary["rows"])
+
+        # Summary statistics, accumulated chunk by chunk while recording
+        log.info("Simulation duration: %.2f seconds", summary["duration"])
+        log.info(
+            "Average throughput: DL=%.2f Mbps, UL=%.2f Mbps",
+            summary["mean_dl"],
+            summary["mean_ul"],
+        )
+        log.info(
+            "Distance range: %.2fm - %.2fm", summary["distance_min"], summary["distance_max"]
+        )
+
+        # Per-STA spread from the online statistics
+        seen = stats.sta_dl.count > 0
+        if seen.any():
+            sketch = stats.sta_dl_sketch
+            log.info(
+                "Per-STA DL over %d intervals: mean %.2f - %.2f Mbps, std up to %.2f Mbps, "
+                "p95 up to %.2f Mbps",
+                stats.intervals,
+                stats.sta_dl.mean[seen].min(),
+                stats.sta_dl.mean[seen].max(),
+                np.sqrt(stats.sta_dl.variance()[seen]).max(),
+                np.nanmax(sketch.quantile(0.95)),
             )
+            if sketch.clipped.any():
+                log.info(
+                    "DL quantiles clipped: %d values outside %.0f - %.0f Mbps",
+                    sketch.clipped.sum(),
+                    sketch.low,
+                    sketch.high,
+                )
     else:
-        print("python: No data collected during simulation.")
+        log.warning("No data collected during simulation.")
 
     # Clean up experiment object and shared memory
     del exp
-    print("python: WiFi Network Simulation - Python Analysis Completed")
+    log.info("WiFi Network Simulation - Python Analysis Completed")
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Texas State University
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+# Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+# PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+# Texas State University
+
+"""
+WiFi Network Simulation - Benchmark Matrix
+
+Runs fixed scenarios over a matrix of STA counts, report intervals, IPC modes
+and traffic models, one run at a time so the runs do not compete for cores:
+- ipc-mode none runs the simulation alone (telemetry log, native controller)
+- the other modes run wifi_analysis_and_control.py as the Python peer
+- traffic "bulk" is the saturated OnOff model, "cbr" the default UDP clients
+
+The simulation appends its own metrics (--benchmarkFile: events/s, simulated s
+per wall s, IPC round trip p50/p95/p99, peak RSS); this script adds the peak
+RSS of the whole run (largest process, simulation or Python peer) and the
+output bytes (telemetry log or CSV). Results are written as JSON Lines, one
+object per run, plus the same rows as CSV.
+
+With --baseline the results are compared to an earlier results.jsonl and the
+script exits with status 1 if a metric regressed by more than --tolerance.
+
+Run from the deployed example directory once the example is built:
+    python3 wifi_benchmark.py -o benchmark_results
+    python3 wifi_benchmark.py --baseline benchmark_results/results.jsonl -o new_results
+"""
+
+import argparse
+import csv
+import json
+import os
+import subprocess
+import sys
+
+# Default matrix (every combination is run)
+N_STAS = [8, 64, 256]
+INTERVALS = [0.25, 0.01]
+IPC_MODES = ["per-sta", "batch", "async", "none"]
+TRAFFIC = ["cbr", "bulk"]
+TRAFFIC_MODELS = {"cbr": "cbr", "bulk": "saturated"}  # Benchmark name -> trafficModel
+
+# Metrics checked against the baseline: +1 higher is better, -1 lower is better
+REGRESSION_METRICS = {
+    "events_per_s": 1,
+    "sim_s_per_wall_s": 1,
+    "ipc_rtt_p99_us": -1,
+    "sim_peak_rss_kb": -1,
+}
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+NS3_ROOT = os.path.join(SCRIPT_DIR, "../../../..")  # contrib/ai/examples/wifi-simulation
+
+
+def run_name(n_stas, interval, ipc_mode, traffic):
+    """Key of one matrix point, stable across benchmark runs"""
+    return f"{ipc_mode}_{n_stas}sta_{round(interval * 1000)}ms_{traffic}"
+
+
+def point_command(args, n_stas, interval, ipc_mode, traffic, output, bench_file):
+    """Command line and working directory of one matrix point"""
+    options = {
+        "interval": interval,
+        "totalTime": args.total_time,
+        "trafficModel": TRAFFIC_MODELS[traffic],
+        "run": args.run,
+        "benchmarkFile": bench_file,
+    }
+    if ipc_mode == "none":
+        options.update(nStas=n_stas, ipcMode="none", verbosity=0, telemetryFile=output)
+        program = " ".join(["ns3ai_wifi_simulation"] + [f"--{k}={v}" for k, v in options.items()])
+        return ["./ns3", "run", "--no-build", program], NS3_ROOT
+    command = [
+        sys.executable,
+        "wifi_analysis_and_control.py",
+        "--ipc-mode",
+        ipc_mode,
+        "--n-stas",
+        str(n_stas),
+        "--verbosity",
+        "0",
+        "--shm-prefix",
+        f"bench{os.getpid()}",
+        "--csv",
+        output,
+    ]
+    for key, value in options.items():
+        command += ["--ns3-arg", f"{key}={value}"]
+    return command, SCRIPT_DIR
+
+
+def run_point(args, n_stas, interval, ipc_mode, traffic):
+    """Run one matrix point; return its result row"""
+    name = run_name(n_stas, interval, ipc_mode, traffic)
+    output = os.path.join(args.output, name + (".bin" if ipc_mode == "none" else ".csv"))
+    bench_file = os.path.join(args.output, name + ".json")
+    for path in (output, bench_file):
+        if os.path.exists(path):
+            os.remove(path)
+
+    command, cwd = point_command(args, n_stas, interval, ipc_mode, traffic, output, bench_file)
+    with open(os.path.join(args.output, name + ".log"), "w") as log:
+        proc = subprocess.Popen(command, cwd=cwd, stdout=log, stderr=subprocess.STDOUT)
+        # wait4 reports the peak RSS of the largest process in the run's process tree
+        _, status, usage = os.wait4(proc.pid, 0)
+    exit_code = os.waitstatus_to_exitcode(status)
+
+    row = {"name": name, "traffic": traffic, "exit_code": exit_code}
+    if exit_code == 0 and os.path.exists(bench_file):
+        with open(bench_file) as f:
+            row.update(json.loads(f.read().splitlines()[-1]))
+    row["run_peak_rss_kb"] = usage.ru_maxrss
+    row["output_bytes"] = os.path.getsize(output) if os.path.exists(output) else 0
+    return row
+
+
+def compare(results, baseline_path, tolerance):
+    """Print the regressions against a baseline results.jsonl; return their number"""
+    with open(baseline_path) as f:
+        baseline = {row["name"]: row for row in map(json.loads, f) if row.get("exit_code") == 0}
+    regressions = 0
+    for row in results:
+        base = baseline.get(row["name"])
+        if base is None or row["exit_code"] != 0:
+            continue
+        for metric, sign in REGRESSION_METRICS.items():
+            old, new = base.get(metric, 0.0), row.get(metric, 0.0)
+            if old <= 0.0:
+                continue  # No baseline value (e.g. no round trips in ipc-mode none)
+            change = sign * (new - old) / old
+            if change < -tolerance:
+                percent = 100.0 * (new - old) / old
+                print(
+                    f"REGRESSION {row['name']} {metric}: {old:.6g} -> {new:.6g} ({percent:+.1f}%)"
+                )
+                regressions += 1
+    return regressions
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="WiFi simulation benchmark matrix")
+    parser.add_argument(
+        "-o",
+        "--output",
+        default="benchmark_results",
+        help="directory for results.jsonl, results.csv and the per-run outputs and logs "
+        "(default: benchmark_results)",
+    )
+    parser.add_argument("--n-stas", type=int, nargs="+", default=N_STAS, help="STA counts")
+    parser.add_argument(
+        "--intervals", type=float, nargs="+", default=INTERVALS, help="report intervals (s)"
+    )
+    parser.add_argument(
+        "--ipc-modes",
+        nargs="+",
+        choices=IPC_MODES + ["vector", "ring"],
+        default=IPC_MODES,
+        help="IPC modes (none: simulation only)",
+    )
+    parser.add_argument(
+        "--traffic", nargs="+", choices=TRAFFIC, default=TRAFFIC, help="traffic models"
+    )
+    parser.add_argument(
+        "--total-time",
+        type=float,
+        default=5.0,
+        help="simulated seconds per run (default: 5.0)",
+    )
+    parser.add_argument("--run", type=int, default=1, help="RNG run number of every run")
+    parser.add_argument(
+        "--baseline", default=None, help="results.jsonl of an earlier benchmark to compare to"
+    )
+    parser.add_argument(
+        "--tolerance",
+        type=float,
+        default=0.10,
+        help="relative change of a metric counted as a regression (default: 0.10)",
+    )
+    args = parser.parse_args()
+    args.output = os.path.abspath(args.output)
+    os.makedirs(args.output, exist_ok=True)
+
+    results = []
+    points = [
+        (n, i, m, t)
+        for n in args.n_stas
+        for i in args.intervals
+        for m in args.ipc_modes
+        for t in args.traffic
+    ]
+    with open(os.path.join(args.output, "results.jsonl"), "w") as jsonl:
+        for count, point in enumerate(points, 1):
+            row = run_point(args, *point)
+            results.append(row)
+            jsonl.write(json.dumps(row) + "\n")
+            jsonl.flush()
+            print(
+                f"[{count}/{len(points)}] {row['name']}: "
+                + (
+                    f"{row.get('events_per_s', 0.0):.0f} events/s, "
+                    f"{row.get('sim_s_per_wall_s', 0.0):.3f} sim s/wall s, "
+                    f"IPC p99 {row.get('ipc_rtt_p99_us', 0.0):.1f} us"
+                    if row["exit_code"] == 0
+                    else f"failed (exit {row['exit_code']})"
+                )
+            )
+
+    fields = []
+    for row in results:
+        fields += [key for key in row if key not in fields]
+    with open(os.path.join(args.output, "results.csv"), "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=fields)
+        writer.writeheader()
+        writer.writerows(results)
+
+    failed = sum(row["exit_code"] != 0 for row in results)
+    regressions = compare(results, args.baseline, args.tolerance) if args.baseline else 0
+    print(f"{len(results)} runs, {failed} failed, {regressions} regressions: {args.output}")
+    sys.exit(1 if failed or regressions else 0)
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2025 Texas State University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+ * PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+ * Texas State University
+ */
+
+/**
+ * @file wifi_cached_loss_model.h
+ * @brief Propagation loss with a per-node-pair cache of the deterministic path loss
+ *
+ * YansWifiChannel evaluates the loss chain from every transmitter to every
+ * other PHY, so dense scenarios spend most of their event-processing time in
+ * log10() calls for node pairs that have barely moved. CachedPairLossModel:
+ * - Evaluates a deterministic chain (e.g. LogDistance stages) once per node
+ *   pair and reuses the loss until either node moves more than
+ *   DistanceThreshold from where the loss was computed
+ * - Optionally prunes receivers beyond PruneRange or with a mean Rx power
+ *   below PruneRxPower before the fading draw
+ * - Applies the fading model (e.g. Nakagami) to the cached mean power of the
+ *   receivers that were not pruned
+ *
+ * With MaxSpeed set to the fastest node speed, a node's position is only
+ * read again once it could have covered the threshold, so static and slow
+ * nodes cost one hash lookup per frame.
+ * The cached loss differs from the exact loss by at most the change over
+ * 2 x DistanceThreshold of a pair's distance.
+ */
+
+#ifndef WIFI_CACHED_LOSS_MODEL_H
+#define WIFI_CACHED_LOSS_MODEL_H
+
+#include "ns3/double.h"
+#include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
+#include "ns3/pointer.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class CachedPairLossModel
+ * @brief Cached deterministic loss, receiver pruning, then fading
+ */
+class CachedPairLossModel : public ns3::PropagationLossModel
+{
+  public:
+    /// Rx power of a pruned receiver (dBm), below every PHY sensitivity
+    static constexpr double PRUNED_RX_DBM = -1000.0;
+
+    static ns3::TypeId GetTypeId()
+    {
+        static ns3::TypeId tid =
+            ns3::TypeId("ns3::CachedPairLossModel")
+                .SetParent<ns3::PropagationLossModel>()
+                .SetGroupName("Propagation")
+                .AddConstructor<CachedPairLossModel>()
+                .AddAttribute("DeterministicModel",
+                              "Loss chain evaluated once per node pair and cached",
+                              ns3::PointerValue(),
+                              ns3::MakePointerAccessor(&CachedPairLossModel::m_deterministic),
+                              ns3::MakePointerChecker<ns3::PropagationLossModel>())
+                .AddAttribute("FadingModel",
+                              "Loss chain applied on every frame to receivers not pruned",
+                              ns3::PointerValue(),
+                              ns3::MakePointerAccessor(&CachedPairLossModel::m_fading),
+                              ns3::MakePointerChecker<ns3::PropagationLossModel>())
+                .AddAttribute("DistanceThreshold",
+                              "Movement (m) of either node that invalidates a cached loss",
+                              ns3::DoubleValue(0.5),
+                              ns3::MakeDoubleAccessor(&CachedPairLossModel::m_threshold),
+                              ns3::MakeDoubleChecker<double>(0.0))
+                .AddAttribute("MaxSpeed",
+                              "Fastest node speed (m/s) used to skip position reads, "
+                              "0 reads both positions on every frame",
+                              ns3::DoubleValue(0.0),
+                              ns3::MakeDoubleAccessor(&CachedPairLossModel::m_maxSpeed),
+                              ns3::MakeDoubleChecker<double>(0.0))
+                .AddAttribute("PruneRange",
+                              "Receivers farther than this (m) get no signal, 0 disables",
+                              ns3::DoubleValue(0.0),
+                              ns3::MakeDoubleAccessor(&CachedPairLossModel::m_pruneRange),
+                              ns3::MakeDoubleChecker<double>(0.0))
+                .AddAttribute("PruneRxPower",
+                              "Receivers whose mean Rx power (dBm, before fading) is below "
+                              "this get no signal",
+                              ns3::DoubleValue(PRUNED_RX_DBM),
+                              ns3::MakeDoubleAccessor(&CachedPairLossModel::m_pruneRxDbm),
+                              ns3::MakeDoubleChecker<double>());
+        return tid;
+    }
+
+    /// @return Number of deterministic loss evaluations (cache misses)
+    uint64_t GetMissCount() const
+    {
+        return m_misses;
+    }
+
+    /// @return Number of frames served from the cache
+    uint64_t GetHitCount() const
+    {
+        return m_hits;
+    }
+
+    /// @return Number of receivers pruned before the fading draw
+    uint64_t GetPrunedCount() const
+    {
+        return m_pruned;
+    }
+
+  private:
+    /// Position anchor of one node
+    struct NodeEntry
+    {
+        ns3::Vector anchor;  ///< Position at the last re-anchoring
+        uint32_t epoch;      ///< Incremented on every re-anchoring
+        ns3::Time nextCheck; ///< Earliest time the node may have left the threshold
+    };
+
+    /// Cached loss of one node pair
+    struct PairEntry
+    {
+        uint32_t epochA; ///< Epoch of the lower-index node when cached
+        uint32_t epochB; ///< Epoch of the higher-index node when cached
+        double lossDb;   ///< Deterministic loss (dB)
+        bool pruned;     ///< Receiver beyond the pruning cutoffs
+    };
+
+    /**
+     * Index of a node, re-anchoring it if it may have moved past the threshold
+     * @param mobility Mobility model of the node
+     * @return Index into m_nodes
+     */
+    uint32_t Track(ns3::Ptr<ns3::MobilityModel> mobility) const
+    {
+        auto [it, inserted] = m_index.try_emplace(ns3::PeekPointer(mobility), m_nodes.size());
+        ns3::Time now = ns3::Simulator::Now();
+        if (inserted)
+        {
+            m_nodes.push_back({mobility->GetPosition(), 0, now});
+            return it->second;
+        }
+        NodeEntry &node = m_nodes[it->second];
+        if (now < node.nextCheck)
+        {
+            return it->second;
+        }
+        ns3::Vector position = mobility->GetPosition();
+        double moved = ns3::CalculateDistance(position, node.anchor);
+        if (moved > m_threshold)
+        {
+            node.anchor = position;
+            ++node.epoch;
+            moved = 0.0;
+        }
+        // The node needs at least (threshold - moved) / speed to leave the threshold
+        node.nextCheck = m_maxSpeed > 0.0 ? now + ns3::Seconds((m_threshold - moved) / m_maxSpeed)
+                                          : now;
+        return it->second;
+    }
+
+    double DoCalcRxPower(double txPowerDbm,
+                         ns3::Ptr<ns3::MobilityModel> a,
+                         ns3::Ptr<ns3::MobilityModel> b) const override
+    {
+        uint32_t i = Track(a);
+        uint32_t j = Track(b);
+        // Deterministic loss is symmetric: one entry per unordered pair
+        uint32_t lo = std::min(i, j);
+        uint32_t hi = std::max(i, j);
+        uint64_t key = (static_cast<uint64_t>(lo) << 32) | hi;
+        const NodeEntry &nodeA = m_nodes[lo];
+        const NodeEntry &nodeB = m_nodes[hi];
+
+        auto [it, inserted] = m_pairs.try_emplace(key);
+        PairEntry &pair = it->second;
+        if (inserted || pair.epochA != nodeA.epoch || pair.epochB != nodeB.epoch)
+        {
+            ++m_misses;
+            pair.epochA = nodeA.epoch;
+            pair.epochB = nodeB.epoch;
+            // Deterministic models only subtract a loss, so any reference power works
+            pair.lossDb = m_deterministic ? -m_deterministic->CalcRxPower(0.0, a, b) : 0.0;
+            double distance = ns3::CalculateDistance(nodeA.anchor, nodeB.anchor);
+            pair.pruned = m_pruneRange > 0.0 && distance > m_pruneRange;
+        }
+        else
+        {
+            ++m_hits;
+        }
+
+        double rxDbm = txPowerDbm - pair.lossDb;
+        if (pair.pruned || rxDbm < m_pruneRxDbm)
+        {
+            ++m_pruned;
+            return PRUNED_RX_DBM;
+        }
+        return m_fading ? m_fading->CalcRxPower(rxDbm, a, b) : rxDbm;
+    }
+
+    int64_t DoAssignStreams(int64_t stream) override
+    {
+        int64_t used = 0;
+        if (m_deterministic)
+        {
+            used += m_deterministic->AssignStreams(stream + used);
+        }
+        if (m_fading)
+        {
+            used += m_fading->AssignStreams(stream + used);
+        }
+        return used;
+    }
+
+    ns3::Ptr<ns3::PropagationLossModel> m_deterministic; ///< Cached loss chain
+    ns3::Ptr<ns3::PropagationLossModel> m_fading;        ///< Per-frame loss chain
+    double m_threshold = 0.5;                            ///< Re-anchoring distance (m)
+    double m_maxSpeed = 0.0;                             ///< Fastest node speed (m/s)
+    double m_pruneRange = 0.0;                           ///< Pruning range (m), 0: off
+    double m_pruneRxDbm = PRUNED_RX_DBM;                 ///< Pruning Rx power (dBm)
+
+    mutable std::unordered_map<const ns3::MobilityModel *, uint32_t> m_index; ///< Node indices
+    mutable std::vector<NodeEntry> m_nodes;                                   ///< Node anchors
+    mutable std::unordered_map<uint64_t, PairEntry> m_pairs;                  ///< Pair cache
+    mutable uint64_t m_misses = 0; ///< Deterministic evaluations
+    mutable uint64_t m_hits = 0;   ///< Cached frames
+    mutable uint64_t m_pruned = 0; ///< Pruned receivers
+};
+
+#endif // WIFI_CACHED_LOSS_MODEL_H
@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) 2025 Texas State University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+ * PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+ * Texas State University
+ */
+
+/**
+ * @file wifi_channel_trace.h
+ * @brief Recorded node positions and link gains, and the models that replay them
+ *
+ * A recording run samples every step seconds the position of every node and
+ * the gain of every node pair (the scenario's loss chain, fading included,
+ * evaluated once per pair and sample), and its frames get the gains of the
+ * sample they fall in (SampledLossModel). Replay runs then see exactly the same
+ * movement and channel whatever their policy does, and the same gains as the
+ * recording run:
+ * - TraceMobilityModel moves a node along its recorded positions, linearly
+ *   between two samples (waypoints every step)
+ * - TraceLossModel applies the recorded gain of the sample a frame falls in
+ *   (block fading: one fading draw per link and step, the same in every replay)
+ *
+ * File layout (native byte order), fixed-size samples for random access:
+ * - ChannelTraceHeader
+ * - sample_count samples: node_count (x, y) float32 positions (m), then
+ *   node_count x (node_count - 1) / 2 float32 gains (dB), pairs (i, j), i < j,
+ *   in row order; sample s is taken at s x step
+ * Nodes are the APs, then the STAs, in scenario order. ChannelTraceReader maps
+ * the file, so replays only page in the samples they reach.
+ */
+
+#ifndef WIFI_CHANNEL_TRACE_H
+#define WIFI_CHANNEL_TRACE_H
+
+#include "ns3/assert.h"
+#include "ns3/callback.h"
+#include "ns3/mobility-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/simulator.h"
+#include "ns3/vector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// Magic bytes at the start of every channel trace
+constexpr char WIFI_TRACE_MAGIC[8] = {'W', 'I', 'F', 'I', 'T', 'R', 'C', '\0'};
+
+/// Version of the channel trace layout
+constexpr uint16_t WIFI_TRACE_VERSION = 1;
+
+/**
+ * @struct ChannelTraceHeader
+ * @brief Fixed header at the start of a channel trace
+ */
+struct ChannelTraceHeader
+{
+    char magic[8];         ///< WIFI_TRACE_MAGIC
+    uint16_t version;      ///< WIFI_TRACE_VERSION
+    uint16_t reserved;     ///< 0
+    uint32_t node_count;   ///< Nodes of the scenario (APs, then STAs)
+    uint32_t ap_count;     ///< APs among them
+    uint32_t sample_count; ///< Samples that follow the header (set when the trace is closed)
+    double step;           ///< Time between two samples (s)
+};
+
+/// @return Number of node pairs (gains per sample) of n nodes
+inline uint64_t
+TracePairCount(uint32_t n)
+{
+    return static_cast<uint64_t>(n) * (n - 1) / 2;
+}
+
+/// @return Bytes of one sample of n nodes
+inline uint64_t
+TraceSampleBytes(uint32_t n)
+{
+    return (2 * static_cast<uint64_t>(n) + TracePairCount(n)) * sizeof(float);
+}
+
+/**
+ * @param n Number of nodes
+ * @param i Lower node index
+ * @param j Higher node index (i < j < n)
+ * @return Index of the gain of pair (i, j) within a sample
+ */
+inline uint64_t
+TracePairIndex(uint32_t n, uint32_t i, uint32_t j)
+{
+    return static_cast<uint64_t>(i) * (2 * static_cast<uint64_t>(n) - i - 1) / 2 + (j - i - 1);
+}
+
+/**
+ * @class ChannelTraceWriter
+ * @brief Appends samples to a channel trace and records their count on Close()
+ */
+class ChannelTraceWriter
+{
+  public:
+    /**
+     * Create the trace file and write its header
+     * @param path Output file path
+     * @param nodes Number of nodes (APs, then STAs)
+     * @param aps Number of APs
+     * @param step Time between two samples (s)
+     * @return false if the file could not be written
+     */
+    bool Open(const std::string &path, uint32_t nodes, uint32_t aps, double step)
+    {
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file)
+        {
+            return false;
+        }
+        std::memcpy(m_header.magic, WIFI_TRACE_MAGIC, sizeof(m_header.magic));
+        m_header.version = WIFI_TRACE_VERSION;
+        m_header.node_count = nodes;
+        m_header.ap_count = aps;
+        m_header.sample_count = 0;
+        m_header.step = step;
+        m_file.write(reinterpret_cast<const char *>(&m_header), sizeof(m_header));
+        return static_cast<bool>(m_file);
+    }
+
+    /**
+     * Append one sample
+     * @param positions 2 x node_count values: x and y of every node (m)
+     * @param gains TracePairCount(node_count) gains (dB)
+     * @return false if the sample could not be written
+     */
+    bool Append(const std::vector<float> &positions, const std::vector<float> &gains)
+    {
+        m_file.write(reinterpret_cast<const char *>(positions.data()),
+                     positions.size() * sizeof(float));
+        m_file.write(reinterpret_cast<const char *>(gains.data()), gains.size() * sizeof(float));
+        ++m_header.sample_count;
+        return static_cast<bool>(m_file);
+    }
+
+    /// @return Samples appended so far
+    uint32_t GetSampleCount() const
+    {
+        return m_header.sample_count;
+    }
+
+    /// @return true while the trace is being written
+    bool IsOpen() const
+    {
+        return m_file.is_open();
+    }
+
+    /// Write the sample count into the header and close the file
+    void Close()
+    {
+        if (m_file.is_open())
+        {
+            m_file.seekp(0);
+            m_file.write(reinterpret_cast<const char *>(&m_header), sizeof(m_header));
+            m_file.close();
+        }
+    }
+
+  private:
+    std::ofstream m_file;        ///< Output file
+    ChannelTraceHeader m_header; ///< Header, rewritten with the final count on Close()
+};
+
+/**
+ * @class ChannelTraceReader
+ * @brief Read-only memory mapping of a channel trace
+ */
+class ChannelTraceReader
+{
+  public:
+    ChannelTraceReader() = default;
+    ChannelTraceReader(const ChannelTraceReader &) = delete;
+    ChannelTraceReader &operator=(const ChannelTraceReader &) = delete;
+
+    ~ChannelTraceReader()
+    {
+        Close();
+    }
+
+    /**
+     * Map a trace file
+     * @param path Trace file path
+     * @return false if the file cannot be mapped, is not a complete trace of
+     *         this layout version or holds no sample
+     */
+    bool Open(const std::string &path)
+    {
+        Close();
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat st;
+        bool mapped = fstat(fd, &st) == 0 &&
+                      static_cast<std::size_t>(st.st_size) >= sizeof(ChannelTraceHeader);
+        if (mapped)
+        {
+            m_size = st.st_size;
+            m_base = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+            mapped = m_base != MAP_FAILED;
+            m_base = mapped ? m_base : nullptr;
+        }
+        close(fd);
+        if (!mapped)
+        {
+            return false;
+        }
+        m_header = static_cast<const ChannelTraceHeader *>(m_base);
+        m_sampleBytes = TraceSampleBytes(m_header->node_count);
+        if (std::memcmp(m_header->magic, WIFI_TRACE_MAGIC, sizeof(m_header->magic)) != 0 ||
+            m_header->version != WIFI_TRACE_VERSION || m_header->sample_count == 0 ||
+            m_header->step <= 0.0 ||
+            m_size < sizeof(ChannelTraceHeader) + m_header->sample_count * m_sampleBytes)
+        {
+            Close();
+            return false;
+        }
+        // Replays walk the samples forward in time
+        madvise(m_base, m_size, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    /// Unmap the trace
+    void Close()
+    {
+        if (m_base)
+        {
+            munmap(m_base, m_size);
+            m_base = nullptr;
+            m_header = nullptr;
+        }
+    }
+
+    /// @return true while a trace is mapped
+    bool IsOpen() const
+    {
+        return m_base != nullptr;
+    }
+
+    /// @return Nodes of the recorded scenario
+    uint32_t GetNodeCount() const
+    {
+        return m_header->node_count;
+    }
+
+    /// @return APs of the recorded scenario
+    uint32_t GetApCount() const
+    {
+        return m_header->ap_count;
+    }
+
+    /// @return Number of samples
+    uint32_t GetSampleCount() const
+    {
+        return m_header->sample_count;
+    }
+
+    /// @return Time between two samples (s)
+    double GetStep() const
+    {
+        return m_header->step;
+    }
+
+    /// @return Time of the last sample (s), the end of the replayable span
+    double GetDuration() const
+    {
+        return (m_header->sample_count - 1) * m_header->step;
+    }
+
+    /**
+     * @param t Simulation time (s)
+     * @return Last sample taken at or before t (clamped to the recorded span)
+     */
+    uint32_t SampleAt(double t) const
+    {
+        double s = std::floor(t / m_header->step);
+        return static_cast<uint32_t>(
+            std::clamp(s, 0.0, static_cast<double>(m_header->sample_count - 1)));
+    }
+
+    /**
+     * @param sample Sample index
+     * @param node Node index
+     * @return Recorded position of the node (z = 0)
+     */
+    ns3::Vector Position(uint32_t sample, uint32_t node) const
+    {
+        const float *xy = Sample(sample) + 2 * static_cast<uint64_t>(node);
+        return ns3::Vector(xy[0], xy[1], 0.0);
+    }
+
+    /**
+     * @param sample Sample index
+     * @param a First node index
+     * @param b Second node index (not a)
+     * @return Recorded gain of the pair (dB, Rx power minus Tx power)
+     */
+    double GainDb(uint32_t sample, uint32_t a, uint32_t b) const
+    {
+        uint32_t n = m_header->node_count;
+        const float *gains = Sample(sample) + 2 * static_cast<uint64_t>(n);
+        return gains[TracePairIndex(n, std::min(a, b), std::max(a, b))];
+    }
+
+  private:
+    /// @return First value of a sample
+    const float *Sample(uint32_t sample) const
+    {
+        return reinterpret_cast<const float *>(static_cast<const char *>(m_base) +
+                                               sizeof(ChannelTraceHeader) +
+                                               sample * m_sampleBytes);
+    }
+
+    void *m_base = nullptr;                       ///< Mapping of the whole file
+    std::size_t m_size = 0;                       ///< Bytes mapped
+    const ChannelTraceHeader *m_header = nullptr; ///< Header at the start of the mapping
+    uint64_t m_sampleBytes = 0;                   ///< Bytes per sample
+};
+
+/**
+ * @class TraceMobilityModel
+ * @brief Moves a node along its recorded positions, linearly between samples
+ */
+class TraceMobilityModel : public ns3::MobilityModel
+{
+  public:
+    static ns3::TypeId GetTypeId()
+    {
+        static ns3::TypeId tid = ns3::TypeId("ns3::TraceMobilityModel")
+                                     .SetParent<ns3::MobilityModel>()
+                                     .SetGroupName("Mobility")
+                                     .AddConstructor<TraceMobilityModel>();
+        return tid;
+    }
+
+    /**
+     * @param trace Mapped trace (outlives the model)
+     * @param node Index of this node in the trace
+     */
+    void SetTrace(const ChannelTraceReader *trace, uint32_t node)
+    {
+        m_trace = trace;
+        m_node = node;
+    }
+
+    /// @return Index of this node in the trace
+    uint32_t GetTraceNode() const
+    {
+        return m_node;
+    }
+
+  private:
+    ns3::Vector DoGetPosition() const override
+    {
+        double t = ns3::Simulator::Now().GetSeconds();
+        uint32_t s = m_trace->SampleAt(t);
+        ns3::Vector from = m_trace->Position(s, m_node);
+        if (s + 1 >= m_trace->GetSampleCount())
+        {
+            return from;
+        }
+        ns3::Vector to = m_trace->Position(s + 1, m_node);
+        double f = std::min(t / m_trace->GetStep() - s, 1.0);
+        return ns3::Vector(from.x + f * (to.x - from.x), from.y + f * (to.y - from.y), 0.0);
+    }
+
+    void DoSetPosition(const ns3::Vector &) override
+    {
+        // Positions come from the trace only
+    }
+
+    ns3::Vector DoGetVelocity() const override
+    {
+        uint32_t s = m_trace->SampleAt(ns3::Simulator::Now().GetSeconds());
+        if (s + 1 >= m_trace->GetSampleCount())
+        {
+            return ns3::Vector(0.0, 0.0, 0.0);
+        }
+        ns3::Vector from = m_trace->Position(s, m_node);
+        ns3::Vector to = m_trace->Position(s + 1, m_node);
+        double step = m_trace->GetStep();
+        return ns3::Vector((to.x - from.x) / step, (to.y - from.y) / step, 0.0);
+    }
+
+    const ChannelTraceReader *m_trace = nullptr; ///< Mapped trace
+    uint32_t m_node = 0;                         ///< Index of this node in the trace
+};
+
+/**
+ * @class TraceLossModel
+ * @brief Recorded gain of a node pair for the sample a frame falls in
+ *
+ * Both nodes must move with a TraceMobilityModel of the same trace.
+ */
+class TraceLossModel : public ns3::PropagationLossModel
+{
+  public:
+    static ns3::TypeId GetTypeId()
+    {
+        static ns3::TypeId tid = ns3::TypeId("ns3::TraceLossModel")
+                                     .SetParent<ns3::PropagationLossModel>()
+                                     .SetGroupName("Propagation")
+                                     .AddConstructor<TraceLossModel>();
+        return tid;
+    }
+
+    /// @param trace Mapped trace (outlives the model)
+    void SetTrace(const ChannelTraceReader *trace)
+    {
+        m_trace = trace;
+    }
+
+  private:
+    double DoCalcRxPower(double txPowerDbm,
+                         ns3::Ptr<ns3::MobilityModel> a,
+                         ns3::Ptr<ns3::MobilityModel> b) const override
+    {
+        NS_ASSERT(dynamic_cast<const TraceMobilityModel *>(ns3::PeekPointer(a)) &&
+                  dynamic_cast<const TraceMobilityModel *>(ns3::PeekPointer(b)));
+        auto nodeA = static_cast<const TraceMobilityModel *>(ns3::PeekPointer(a));
+        auto nodeB = static_cast<const TraceMobilityModel *>(ns3::PeekPointer(b));
+        uint32_t s = m_trace->SampleAt(ns3::Simulator::Now().GetSeconds());
+        return txPowerDbm + m_trace->GainDb(s, nodeA->GetTraceNode(), nodeB->GetTraceNode());
+    }
+
+    int64_t DoAssignStreams(int64_t) override
+    {
+        return 0;
+    }
+
+    const ChannelTraceReader *m_trace = nullptr; ///< Mapped trace
+};
+
+/**
+ * @class SampledLossModel
+ * @brief Gain of a node pair in the sample a recording run is writing
+ *
+ * Before each evaluation the update callback appends every sample due by now,
+ * so a frame at t gets the gains of sample floor(t / step), as TraceLossModel
+ * gives it in the replays.
+ */
+class SampledLossModel : public ns3::PropagationLossModel
+{
+  public:
+    static ns3::TypeId GetTypeId()
+    {
+        static ns3::TypeId tid = ns3::TypeId("ns3::SampledLossModel")
+                                     .SetParent<ns3::PropagationLossModel>()
+                                     .SetGroupName("Propagation")
+                                     .AddConstructor<SampledLossModel>();
+        return tid;
+    }
+
+    /**
+     * @param gains TracePairCount(node count) gains (dB) of the last sample (outlive the model)
+     * @param update Appends the samples due by now, updating gains
+     */
+    void SetSample(const std::vector<float> *gains, ns3::Callback<void> update)
+    {
+        m_gains = gains;
+        m_update = update;
+    }
+
+    /**
+     * @param mobility Mobility model of a node
+     * @param node Trace node index (APs, then STAs)
+     */
+    void AddNode(ns3::Ptr<ns3::MobilityModel> mobility, uint32_t node)
+    {
+        m_nodes[ns3::PeekPointer(mobility)] = node;
+    }
+
+  private:
+    double DoCalcRxPower(double txPowerDbm,
+                         ns3::Ptr<ns3::MobilityModel> a,
+                         ns3::Ptr<ns3::MobilityModel> b) const override
+    {
+        m_update();
+        auto nodeA = m_nodes.find(ns3::PeekPointer(a));
+        auto nodeB = m_nodes.find(ns3::PeekPointer(b));
+        NS_ASSERT(nodeA != m_nodes.end() && nodeB != m_nodes.end());
+        uint32_t i = std::min(nodeA->second, nodeB->second);
+        uint32_t j = std::max(nodeA->second, nodeB->second);
+        return txPowerDbm + (*m_gains)[TracePairIndex(m_nodes.size(), i, j)];
+    }
+
+    int64_t DoAssignStreams(int64_t) override
+    {
+        return 0;
+    }
+
+    const std::vector<float> *m_gains = nullptr;                      ///< Last sample's gains
+    ns3::Callback<void> m_update;                                     ///< Appends due samples
+    std::unordered_map<const ns3::MobilityModel *, uint32_t> m_nodes; ///< Trace node indices
+};
+
+#endif // WIFI_CHANNEL_TRACE_H
@@ -29,7 +29,7 @@
  * This WiFi simulation captures:
  * - Station (STA) position and mobility
  * - Network throughput metrics (uplink/downlink)
- * - Access Point (AP) transmission parameters
+ * - Access Point (AP) transmission parameters, per AP in multi-BSS scenarios
  * - Real-time network performance data
  */
 
@@ -50,14 +50,143 @@ struct EnvStruct
 {
     double env_pos_x;    ///< STA X position in meters (network topology coordinate)
     double env_pos_y;    ///< STA Y position in meters (network topology coordinate)
-    double env_distance; ///< Distance from STA to AP in meters
+    double env_distance; ///< Distance from STA to its serving AP in meters
     double env_dl_tp;    ///< Downlink throughput in Mbps (AP → STA)
-    double env_ul_tp;    ///< Uplink throughput in Mbps (STA → AP)
-    double env_get_ApTx; ///< Current AP transmission power or MCS index
+    double env_ul_tp;    ///< Uplink throughput in Mbps at the serving AP (all its STAs → AP)
+    double env_get_ApTx; ///< Current transmission power or MCS index of the serving AP
     int env_sta_id;      ///< Station ID (0-based indexing for multi-STA networks)
+    int env_ap_id;       ///< Serving AP (BSS) index, 0 in single-AP scenarios
     double env_now_sec;  ///< Current simulation time in seconds
+
+    // Per-flow statistics over the report interval (FlowMonitor, 0 unless enabled)
+    double env_dl_delay;  ///< Mean DL one-way delay in ms (0 without received packets)
+    double env_dl_jitter; ///< Mean DL delay variation between consecutive packets in ms
+    double env_dl_loss;   ///< Fraction of DL packets sent in the interval but not received
+    double env_ul_delay;  ///< Mean UL one-way delay in ms (0 without received packets)
+    double env_ul_jitter; ///< Mean UL delay variation between consecutive packets in ms
+    double env_ul_loss;   ///< Fraction of UL packets sent in the interval but not received
+
+    // PHY trace counters over the report interval
+    uint32_t env_rx_frames;   ///< Frames decoded by the STA PHY (any sender)
+    uint32_t env_rx_drops;    ///< Frames dropped on reception by the STA PHY
+    uint32_t env_tx_drops;    ///< Frames dropped before transmission by the STA PHY
+    uint32_t env_ap_rx_drops; ///< Frames dropped on reception by the serving AP PHY
+    double env_rssi;          ///< Mean signal of the decoded frames in dBm (0 without frames)
+    double env_snr;           ///< Mean SNR of the decoded frames in dB (0 without frames)
 };
 
+/**
+ * Maximum number of STA records carried by a single EnvBatchStruct.
+ * The shared memory segment created by Python must be large enough to hold
+ * one EnvBatchStruct (576 KiB at this capacity, see BATCH_STRUCT_SIZE in the bindings).
+ */
+constexpr uint32_t WIFI_MAX_BATCH_STAS = 4096;
+
+/**
+ * Maximum number of APs (BSSs) in a scenario, i.e. the number of per-AP
+ * Tx settings an ActStruct can carry.
+ */
+constexpr uint32_t WIFI_MAX_APS = 64;
+
+/// Per-STA MCS action value that keeps the STA's current MCS
+constexpr uint8_t WIFI_MCS_KEEP = 255;
+
+/**
+ * @struct EnvBatchStruct
+ * @brief Batched environment data structure (C++ → Python direction)
+ *
+ * Holds the EnvStruct records of every STA for one report interval so that
+ * the whole report is exchanged in a single shared-memory round trip instead
+ * of one round trip per STA. Only the first env_count records are valid.
+ * This structure is written by C++ and read by Python.
+ */
+struct EnvBatchStruct
+{
+    uint32_t env_count;                         ///< Number of valid entries in env_records
+    EnvStruct env_records[WIFI_MAX_BATCH_STAS]; ///< Per-STA records of the current report
+};
+
+/// Version of the compact report layout (CompactReportHeader and its record structs)
+constexpr uint16_t WIFI_COMPACT_VERSION = 1;
+
+/**
+ * @struct CompactReportHeader
+ * @brief Per-report fields of a compact report (C++ → Python direction)
+ *
+ * Written at the start of every CompactBatchStruct, so Python can check that
+ * its bindings use the same layout (version and record sizes) before reading
+ * the records.
+ */
+struct CompactReportHeader
+{
+    uint16_t version;         ///< WIFI_COMPACT_VERSION
+    uint16_t ap_record_size;  ///< sizeof(CompactApRecord)
+    uint16_t sta_record_size; ///< sizeof(CompactStaRecord)
+    uint16_t ap_count;        ///< Number of valid entries in CompactBatchStruct::aps
+    uint32_t sta_count;       ///< Number of valid entries in CompactBatchStruct::stas
+    uint32_t reserved;        ///< Unused, 0
+    double now_sec;           ///< Simulation time of the report in seconds
+};
+
+/**
+ * @struct CompactApRecord
+ * @brief Per-AP fields of a compact report, shared by every STA of the BSS
+ */
+struct CompactApRecord
+{
+    float pos_x;       ///< AP X position in meters
+    float pos_y;       ///< AP Y position in meters
+    float tx_power;    ///< Tx power of the AP during the interval in dBm (EnvStruct get_ApTx)
+    float ul_tp;       ///< Uplink throughput at the AP in Mbps (all its STAs → AP)
+    uint32_t rx_drops; ///< Frames dropped on reception by the AP PHY
+};
+
+/**
+ * @struct CompactStaRecord
+ * @brief Per-STA fields of a compact report (64 bytes instead of the 144 of EnvStruct)
+ *
+ * Same units as the EnvStruct fields of the same name. The distance to the
+ * serving AP follows from the positions, the other per-AP fields come from
+ * aps[ap_id].
+ */
+struct CompactStaRecord
+{
+    float pos_x;        ///< STA X position in meters
+    float pos_y;        ///< STA Y position in meters
+    float dl_tp;        ///< Downlink throughput in Mbps (AP → STA)
+    float dl_delay;     ///< Mean DL one-way delay in ms
+    float dl_jitter;    ///< Mean DL delay variation in ms
+    float dl_loss;      ///< DL loss fraction
+    float ul_delay;     ///< Mean UL one-way delay in ms
+    float ul_jitter;    ///< Mean UL delay variation in ms
+    float ul_loss;      ///< UL loss fraction
+    float rssi;         ///< Mean signal of the decoded frames in dBm (0 without frames)
+    float snr;          ///< Mean SNR of the decoded frames in dB (0 without frames)
+    uint32_t rx_frames; ///< Frames decoded by the STA PHY
+    uint32_t rx_drops;  ///< Frames dropped on reception by the STA PHY
+    uint32_t tx_drops;  ///< Frames dropped before transmission by the STA PHY
+    uint32_t sta_id;    ///< Station ID
+    uint16_t ap_id;     ///< Serving AP (BSS) index, entry of CompactBatchStruct::aps
+    uint16_t reserved;  ///< Unused, 0
+};
+
+/**
+ * @struct CompactBatchStruct
+ * @brief Compact batched report (C++ → Python direction, wireFormat=compact)
+ *
+ * The same report as an EnvBatchStruct with the per-report and per-AP fields
+ * sent once and float32 per-STA values: 257 KiB instead of 576 KiB at full
+ * capacity, 64 bytes per STA record.
+ */
+struct CompactBatchStruct
+{
+    CompactReportHeader header;                 ///< Per-report fields and layout tags
+    CompactApRecord aps[WIFI_MAX_APS];          ///< Per-AP fields, indexed by AP id
+    CompactStaRecord stas[WIFI_MAX_BATCH_STAS]; ///< Per-STA records of the current report
+};
+
+static_assert(sizeof(CompactStaRecord) == 64, "CompactStaRecord is one cache line");
+
 /**
  * @struct ActStruct
  * @brief Action data structure (Python → C++ direction)
@@ -65,12 +194,40 @@ struct EnvStruct
  * Contains control commands computed by Python AI/ML algorithms
  * that need to be applied to the NS3 WiFi simulation. This structure
  * is written by Python and read by C++.
+ *
+ * With act_count == 0 env_set_ApTx applies to every AP (single-AP scripts
+ * only ever write env_set_ApTx). Otherwise the first act_count entries of
+ * act_set_ApTx set the AP with the same index; the other APs keep their power.
+ *
+ * Per-STA and vector modes exchange this structure; the batched modes (batch,
+ * async, ring) exchange an ActBatchStruct, which adds the per-STA actions.
  */
 struct ActStruct
 {
-    double env_set_ApTx; ///< New AP transmission power/MCS to set (Python → C++)
-                         ///< Can be used for adaptive transmission control,
-                         ///< power management, or MCS selection algorithms
+    double env_set_ApTx;               ///< New AP Tx power/MCS to set (Python → C++)
+                                       ///< Can be used for adaptive transmission control,
+                                       ///< power management, or MCS selection algorithms
+    uint32_t act_count;                ///< Number of valid per-AP entries in act_set_ApTx
+    double act_set_ApTx[WIFI_MAX_APS]; ///< Per-AP transmission power, indexed by AP id
+};
+
+/**
+ * @struct ActBatchStruct
+ * @brief Action of one batched report with per-STA actions (Python → C++ direction)
+ *
+ * The ActStruct fields, then per-STA actions indexed by STA id in the first
+ * act_sta_count entries of act_sta_mcs and act_sta_txPower (act_sta_count == 0:
+ * none):
+ * - act_sta_mcs sets the HT MCS of the DL (serving AP to STA) and UL (STA to
+ *   AP) data frames of the STA, WIFI_MCS_KEEP keeps the current MCS; only
+ *   applied with rateManager=action
+ * - act_sta_txPower sets the Tx power of the STA, NaN keeps the current power
+ */
+struct ActBatchStruct : ActStruct
+{
+    uint32_t act_sta_count;                      ///< Number of valid per-STA entries below
+    uint8_t act_sta_mcs[WIFI_MAX_BATCH_STAS];    ///< Per-STA HT MCS (0-7), indexed by STA id
+    double act_sta_txPower[WIFI_MAX_BATCH_STAS]; ///< Per-STA Tx power (dBm), indexed by STA id
 };
 
 #endif // WIFI_DATA_STRUCTURES_H
\ No newline at end of file
@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Texas State University
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+# Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+# PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+# Texas State University
+
+"""
+WiFi Network Simulation - Live Dashboard
+
+Watches a running simulation (ipcMode=ring) as a read-only observer of its
+telemetry ring, next to the controller (wifi_analysis_and_control.py):
+- STA positions, colored by serving AP
+- DL and UL throughput of every STA in the newest report
+- Tx power trajectory of every AP (mean reported ApTx of its STAs)
+
+The dashboard never slows the simulation or the controller down: the
+simulation only waits for ring reader 0 (the controller), never for an
+observer. At each refresh (at most --fps per second) the dashboard drains
+the ring and draws only the newest complete report; the older ones are
+dropped, and reports the simulation overwrote before the dashboard got to
+them are counted as skipped.
+
+Run beside the controller, with the same shared-memory prefix:
+    python3 wifi_analysis_and_control.py --ipc-mode ring
+    python3 wifi_live_dashboard.py
+"""
+
+# Data visualization libraries
+import matplotlib.pyplot as plt
+import numpy as np
+
+# Import the compiled Python binding module (created from wifi_python_bindings.cc)
+import ns3ai_wifi_py as py_binding
+
+# Standard libraries
+import argparse
+import collections
+import time
+
+
+def drain(ring, newest):
+    """
+    Read every ready record; return a copy of the newest complete report
+    (newest itself if no record was ready)
+    """
+    while True:
+        view = ring.poll()
+        if len(view) == 0:
+            return newest
+        # Only the STAs of the last report in the span are kept (boolean indexing copies them)
+        now = view["now_sec"][-1]
+        rows = view[view["now_sec"] == now]
+        if not ring.release():
+            continue  # Overwritten while copied: keep the previous report
+        if newest is not None and len(newest) and newest["now_sec"][0] == now:
+            rows = np.concatenate((newest, rows))  # Report split by the end of the ring
+        newest = rows
+
+
+class Dashboard:
+    """Figure with persistent artists, updated from one report at a time"""
+
+    def __init__(self, history):
+        """history: number of reports kept of the Tx power trajectories"""
+        self.fig, (self.map_ax, self.tp_ax, self.tx_ax) = plt.subplots(1, 3, figsize=(16, 5))
+        self.map_ax.set_title("STA positions")
+        self.map_ax.set_xlabel("x (m)")
+        self.map_ax.set_ylabel("y (m)")
+        self.map_ax.grid(True)
+        self.stas = self.map_ax.scatter([], [], c=[], cmap="tab10", vmin=0, vmax=9, s=30)
+
+        self.tp_ax.set_title("Throughput per STA")
+        self.tp_ax.set_xlabel("STA")
+        self.tp_ax.set_ylabel("Mbps")
+        self.tp_ax.grid(True)
+        (self.dl_line,) = self.tp_ax.plot([], [], ".", label="DL")
+        (self.ul_line,) = self.tp_ax.plot([], [], ".", label="UL at serving AP")
+        self.tp_ax.legend(loc="upper right")
+
+        self.tx_ax.set_title("AP Tx power")
+        self.tx_ax.set_xlabel("Time (s)")
+        self.tx_ax.set_ylabel("ApTx")
+        self.tx_ax.grid(True)
+        self.times = collections.deque(maxlen=history)
+        self.ap_tx = collections.deque(maxlen=history)  # Mean ApTx per AP, NaN without STAs
+        self.tx_lines = []
+
+        self.status = self.fig.suptitle("Waiting for telemetry...")
+        self.fig.tight_layout()
+
+    def update(self, report, skipped):
+        """Draw one report; skipped: records the dashboard lost so far"""
+        report = np.sort(report, order="sta_id")
+        ap_id = report["ap_id"]
+        positions = np.column_stack((report["pos_x"], report["pos_y"]))
+        self.stas.set_offsets(positions)
+        self.stas.set_array(ap_id % 10)
+        low, high = positions.min(axis=0) - 1, positions.max(axis=0) + 1
+        self.map_ax.set_xlim(low[0], high[0])
+        self.map_ax.set_ylim(low[1], high[1])
+
+        self.dl_line.set_data(report["sta_id"], report["dl_tp"])
+        self.ul_line.set_data(report["sta_id"], report["ul_tp"])
+        self.tp_ax.relim()
+        self.tp_ax.autoscale_view()
+
+        n_aps = int(ap_id.max()) + 1
+        stas = np.bincount(ap_id, minlength=n_aps)
+        tx = np.bincount(ap_id, weights=report["get_ApTx"], minlength=n_aps)
+        self.times.append(report["now_sec"][0])
+        self.ap_tx.append(np.divide(tx, stas, out=np.full(n_aps, np.nan), where=stas > 0))
+        while len(self.tx_lines) < n_aps:
+            (line,) = self.tx_ax.plot([], [], label=f"AP {len(self.tx_lines)}")
+            self.tx_lines.append(line)
+        width = max(len(row) for row in self.ap_tx)
+        trajectory = np.full((len(self.ap_tx), width), np.nan)
+        for i, row in enumerate(self.ap_tx):
+            trajectory[i, : len(row)] = row
+        for k, line in enumerate(self.tx_lines):
+            line.set_data(self.times, trajectory[:, k] if k < width else [])
+        if n_aps <= 8:
+            self.tx_ax.legend(loc="upper right")
+        self.tx_ax.relim()
+        self.tx_ax.autoscale_view()
+
+        self.status.set_text(
+            f"t = {report['now_sec'][0]:.2f} s, {len(report)} STAs, "
+            f"mean DL {report['dl_tp'].mean():.2f} Mbps, {skipped} records skipped"
+        )
+        self.fig.canvas.draw_idle()
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Live dashboard of a ring-mode simulation")
+    parser.add_argument(
+        "--shm-prefix",
+        default="My",
+        help="shared-memory prefix of the simulation (default: My, the simulation's default)",
+    )
+    parser.add_argument(
+        "--reader",
+        type=int,
+        default=1,
+        help="observer cursor of the telemetry ring, 1 or higher, unique among observers "
+        "(default: 1)",
+    )
+    parser.add_argument("--fps", type=float, default=4.0, help="most refreshes per second")
+    parser.add_argument(
+        "--history", type=int, default=2000, help="reports kept of the Tx power trajectories"
+    )
+    parser.add_argument(
+        "--timeout",
+        type=float,
+        default=60.0,
+        help="seconds to wait for the simulation to create its rings (default: 60)",
+    )
+    args = parser.parse_args()
+    if args.reader < 1:
+        parser.error("--reader 0 is the controller; observers use 1 or higher")
+    if not args.fps > 0:
+        parser.error("--fps must be positive")
+
+    ring = py_binding.ShmRing(
+        f"/{args.shm_prefix}WifiRing", reader=args.reader, timeout=args.timeout
+    )
+    dashboard = Dashboard(args.history)
+    plt.show(block=False)
+    newest = None
+    drawn = None
+    period = 1.0 / args.fps
+    try:
+        while plt.fignum_exists(dashboard.fig.number):
+            start = time.monotonic()
+            newest = drain(ring, newest)
+            if newest is not None and newest is not drawn and len(newest):
+                dashboard.update(newest, ring.skipped)
+                drawn = newest
+            if ring.closed:
+                dashboard.status.set_text(dashboard.status.get_text() + " (simulation ended)")
+                plt.show()
+                break
+            # Sleep the rest of the refresh period while the window handles its events
+            plt.pause(max(period - (time.monotonic() - start), 0.001))
+    except KeyboardInterrupt:
+        pass
+    finally:
+        ring.detach()
@@ -38,7 +38,16 @@
  */
 
 // === NS3 CORE MODULES AND WIFI DATA STRUCTURES ===
-#include "wifi_data_structures.h" // WiFi data structures for C++/Python communication
+#include "wifi_action_rate_manager.h" // Station manager with per-STA MCS actions
+#include "wifi_cached_loss_model.h"   // Per-node-pair cached path loss for dense scenarios
+#include "wifi_channel_trace.h"       // Recorded mobility and link gains for replay runs
+#include "wifi_data_structures.h"     // WiFi data structures for C++/Python communication
+#include "wifi_partition.h"           // Spatially independent partitions in worker processes
+#include "wifi_profiler.h"            // Wall-clock profiling of the report hot path
+#include "wifi_shm_ring.h"            // Lock-free shared-memory rings (ipcMode=ring)
+#include "wifi_telemetry_log.h"       // Binary telemetry log for runs without a Python peer
+#include "wifi_traffic.h"             // Poisson and lean-scenario traffic sources and sink
+#include "wifi_tx_power_controller.h" // Native AP Tx power policies
 
 // === NS3 SIMULATION FRAMEWORK ===
 // Core NS3 modules for network simulation, mobility, and traffic
@@ -55,13 +64,39 @@
 #include "ns3/ai-module.h" // NS3-AI communication framework
 
 // === STANDARD C++ LIBRARIES ===
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace ns3;
 
+NS_LOG_COMPONENT_DEFINE("WifiNetworkSimulation");
+NS_OBJECT_ENSURE_REGISTERED(ActionRateWifiManager);
+NS_OBJECT_ENSURE_REGISTERED(CachedPairLossModel);
+NS_OBJECT_ENSURE_REGISTERED(TraceMobilityModel);
+NS_OBJECT_ENSURE_REGISTERED(TraceLossModel);
+NS_OBJECT_ENSURE_REGISTERED(PoissonUdpClient);
+NS_OBJECT_ENSURE_REGISTERED(MultiPeerSource);
+NS_OBJECT_ENSURE_REGISTERED(SharedByteSink);
+
 // === SIMULATION CONFIGURATION PARAMETERS ===
 /*
  * Global configuration for WiFi network simulation:
@@ -69,11 +104,65 @@ using namespace ns3;
  * - Movement pattern: Random waypoint mobility
  * - Traffic pattern: Bidirectional UDP traffic
  * - AI integration: Real-time parameter adaptation
+ * Every scenario parameter can be set on the command line (see AddScenarioOptions),
+ * so one build serves all points of a parameter sweep.
+ */
+struct ScenarioConfig
+{
+    uint32_t nStas = 8;                   // Number of station nodes (STAs) in WiFi network
+    uint32_t nAps = 1;                    // Number of APs, one BSS (SSID) each
+    std::string apTopology = "grid";      // AP layout around the origin: grid or hex
+    double apSpacing = 30.0;              // Distance between neighbouring APs (meters)
+    double initDistance = 1.5;            // Initial distance from its AP to each STA (meters)
+    double totalTime = 50.0;              // Total simulation time (seconds)
+    double interval = 0.25;               // Reporting interval for Python communication (seconds)
+    std::string reportMode = "periodic";  // periodic (every interval) or change (on triggers)
+    double tpDelta = 0.5;                 // Change: DL/UL throughput change that triggers (Mb)
+    double distanceDelta = 1.0;           // Change: STA-AP distance change that triggers (m)
+    double dropRate = 0.1;                // Change: PHY Rx drop fraction that triggers
+    double maxSilence = 5.0;              // Change: heartbeat, longest time between reports (s)
+    double maxInterval = 0.0;             // Change: stretch quiet checks up to this (s), 0: off
+    bool warmStart = false;               // Static ARP, active probing and early traffic start
+    double trafficStart = -1.0;           // Traffic start (s), < 0: interval (0.05 if warmStart)
+    std::string trafficModel = "cbr";     // Traffic sources: cbr, poisson or saturated
+    uint32_t packetSize = 1472;           // UDP payload size of every traffic client (bytes)
+    double clientInterval = 0.001;        // CBR/Poisson: (mean) time between two packets (seconds)
+    std::string onOffRate = "100Mbps";    // Saturated: constant rate of every OnOff source
+    bool lean = false;                    // One multiplexed source per node, one shared sink
+    bool packetSockets = false;           // Lean: packet sockets instead of UDP/IP (no IP stack)
+    uint32_t maxAmpduSize = 65535;        // Best-effort A-MPDU size limit (bytes), 0 disables
+    std::string rateManager = "constant"; // Rate control: constant, action, minstrel or ideal
+    std::string dataMode = "HtMcs1";      // Constant/action: (initial) data mode
+    std::string controlMode = "HtMcs0";   // Constant/action: control mode
+    double mobilityBound = 50.0;          // STAs walk up to bound beyond the outermost APs (meters)
+    double staSpeed = 0.05;               // STA random-walk speed (m/s)
+    double lossExponent = 3.0;            // Log-distance propagation loss exponent
+    std::string lossModel = "exact";      // exact (full loss chain per frame) or cached
+    double lossCacheThreshold = 0.5;      // Cached: movement that invalidates a pair's loss (m)
+    double pruneRange = 0.0;              // Cached: no signal beyond this range (m), 0 disables
+    double pruneRxPower = -1000.0;        // Cached: no signal below this mean Rx power (dBm)
+    uint32_t seed = 1;                    // RNG seed (RngSeedManager::SetSeed)
+    uint64_t run = 1;                     // RNG run number (RngSeedManager::SetRun)
+};
+
+ScenarioConfig g_config; // Scenario parameters of this run
+
+std::string g_ipcMode = "per-sta"; // Exchange mode: per-sta, batch, vector, async, ring or none
+std::string g_wireFormat = "full"; // Batch mode records: full (EnvBatchStruct) or compact
+uint32_t g_queueDepth = 4;         // Reports buffered per exchange in vector mode
+uint32_t g_actionLatency = 1;      // Reports before a Python action is applied in async mode
+std::string g_shmPrefix = "My";    // Prefix of the ns3-ai shared memory names (unique per job)
+
+/*
+ * Console verbosity:
+ * 0: quiet (errors and the end-of-run profile only)
+ * 1: one summary line per report (default)
+ * 2: + setup steps and per-STA lines (NS_LOG_INFO)
+ * 3: + per-message IPC traces (NS_LOG_DEBUG)
+ * Levels 2 and 3 use the WifiNetworkSimulation log component, so they are
+ * compiled out of optimized ns-3 builds and cost one check otherwise.
  */
-uint32_t g_nStas = 8;         // Number of station nodes (STAs) in WiFi network
-double g_init_distance = 1.5; // Initial distance from AP to each STA (meters)
-double g_totalTime = 50.0;    // Total simulation time (seconds)
-double g_interval = 0.25;     // Reporting interval for Python communication (seconds)
+uint32_t g_verbosity = 1;
 
 // === NETWORK TOPOLOGY AND DEVICE CONTAINERS ===
 /*
@@ -81,27 +170,334 @@ double g_interval = 0.25;     // Reporting interval for Python communication (se
  * - Node containers for AP and stations
  * - Network device containers for WiFi interfaces
  * - Mobility models for node movement
- * - Traffic generation servers (UDP)
- */
-std::vector<Ptr<UdpServer>> g_staServers;      // UDP servers on stations for uplink traffic
-Ptr<UdpServer> g_apServer;                     // UDP server on AP for downlink traffic
-Ptr<MobilityModel> g_apMobility;               // Mobility model for Access Point
-std::vector<Ptr<MobilityModel>> g_staMobility; // Mobility models for all stations
-std::vector<uint64_t> g_lastStaRx;             // Last received packet count per STA
-uint64_t g_lastApRx = 0;                       // Last received packet count for AP
-NodeContainer wifiApNode;                      // AP node container
-NodeContainer wifiStaNodes;                    // Station node container
-NetDeviceContainer apDevice;                   // AP network device
-NetDeviceContainer staDevices;                 // Station network devices
+ * - Traffic sinks (UDP PacketSink)
+ */
+NodeContainer wifiApNodes;     // AP node container
+NodeContainer wifiStaNodes;    // Station node container
+NetDeviceContainer apDevices;  // AP network devices
+NetDeviceContainer staDevices; // Station network devices
+Ptr<CachedPairLossModel> g_cachedLoss; // Channel loss model when lossModel is cached
+
+// === PHY TRACE COUNTERS ===
+/*
+ * Per-node counters incremented by the PHY trace sinks (see ConnectPhyTraces)
+ * and reset by GetReport() after every report. Sinks are bound to their
+ * node's counters, so a traced frame costs one increment and no context
+ * string parsing.
+ */
+struct PhyCounters
+{
+    uint32_t rxFrames = 0; // Frames decoded by the PHY (MonitorSnifferRx)
+    uint32_t rxDrops = 0;  // Frames dropped on reception (PhyRxDrop)
+    uint32_t txDrops = 0;  // Frames dropped before transmission (PhyTxDrop)
+    double rssiSum = 0.0;  // Sum of the signal power of decoded frames (dBm)
+    double snrSum = 0.0;   // Sum of the SNR of decoded frames (dB)
+};
+
+// === PER-AP STATE TABLE ===
+/*
+ * Handles and counters of every AP (one BSS each), resolved once by
+ * InitializeScenario(); same struct-of-arrays layout as StaStateTable.
+ */
+struct ApStateTable
+{
+    std::vector<Ptr<PacketSink>> sinks;            // UDP sink on each AP (UL traffic)
+    std::vector<Ptr<MobilityModel>> mobility;      // Mobility model of each AP
+    std::vector<uint64_t> lastRx;                  // Received bytes at the previous report
+    std::vector<Ptr<YansWifiPhy>> phys;            // PHY of each AP (Tx power control)
+    std::vector<PhyCounters> phyStats;             // PHY trace counters since the previous report
+    std::vector<Ssid> ssids;                       // SSID of each BSS
+    std::vector<Ptr<ActionRateWifiManager>> rates; // Per-STA DL MCS (rateManager=action, else null)
+    std::vector<double> sentUl;                    // UL throughput of the last sent report
+    std::vector<uint32_t> ids;                     // Global AP index (ap_id, act_set_ApTx slot)
+
+    uint32_t Size() const
+    {
+        return sinks.size();
+    }
+
+    void Reserve(uint32_t n)
+    {
+        sinks.reserve(n);
+        mobility.reserve(n);
+        lastRx.reserve(n);
+        phys.reserve(n);
+        phyStats.reserve(n);
+        ssids.reserve(n);
+        rates.reserve(n);
+        sentUl.reserve(n);
+        ids.reserve(n);
+    }
+
+    void Add(Ptr<PacketSink> sink,
+             Ptr<MobilityModel> mobilityModel,
+             Ptr<YansWifiPhy> phy,
+             Ssid ssid,
+             Ptr<ActionRateWifiManager> rate,
+             uint32_t id)
+    {
+        sinks.push_back(sink);
+        mobility.push_back(mobilityModel);
+        lastRx.push_back(0);
+        phys.push_back(phy);
+        phyStats.emplace_back();
+        ssids.push_back(ssid);
+        rates.push_back(rate);
+        sentUl.push_back(0.0);
+        ids.push_back(id);
+    }
+};
+
+ApStateTable g_ap; // Per-AP state of this run
+
+// === PER-STA STATE TABLE ===
+/*
+ * Handles and counters of every STA, resolved once by InitializeScenario()
+ * so GetReport() needs no container lookups or DynamicCasts:
+ * - Struct of arrays: one contiguous vector per field, indexed by STA id
+ *   (by local index in partitioned runs, ids holds the global one)
+ * - GetReport() walks the table linearly
+ */
+struct StaStateTable
+{
+    std::vector<Ptr<PacketSink>> sinks;            // UDP sink on each STA (DL traffic)
+    std::vector<Ptr<MobilityModel>> mobility;      // Mobility model of each STA
+    std::vector<uint64_t> lastRx;                  // Received bytes at the previous report
+    std::vector<Ptr<YansWifiPhy>> phys;            // PHY of each STA
+    std::vector<PhyCounters> phyStats;             // PHY trace counters since the previous report
+    std::vector<Ipv4Address> ips;                  // IPv4 address of each STA
+    std::vector<Mac48Address> macs;                // MAC address of each STA (per-STA DL MCS)
+    std::vector<uint32_t> ap;                      // Serving AP (index into g_ap) of each STA
+    std::vector<Ptr<ActionRateWifiManager>> rates; // UL MCS (rateManager=action, else null)
+    std::vector<double> sentDl;                    // DL throughput of the last sent report
+    std::vector<double> sentDistance;              // Distance to the AP in the last sent report
+    std::vector<uint32_t> ids;                     // Global STA index (sta_id, per-STA action slot)
+
+    uint32_t Size() const
+    {
+        return sinks.size();
+    }
+
+    void Reserve(uint32_t n)
+    {
+        sinks.reserve(n);
+        mobility.reserve(n);
+        lastRx.reserve(n);
+        phys.reserve(n);
+        phyStats.reserve(n);
+        ips.reserve(n);
+        macs.reserve(n);
+        ap.reserve(n);
+        rates.reserve(n);
+        sentDl.reserve(n);
+        sentDistance.reserve(n);
+        ids.reserve(n);
+    }
+
+    void Add(Ptr<PacketSink> sink,
+             Ptr<MobilityModel> mobilityModel,
+             Ptr<YansWifiPhy> phy,
+             Ipv4Address ip,
+             Mac48Address mac,
+             uint32_t apIndex,
+             Ptr<ActionRateWifiManager> rate,
+             uint32_t id)
+    {
+        sinks.push_back(sink);
+        mobility.push_back(mobilityModel);
+        lastRx.push_back(0);
+        phys.push_back(phy);
+        phyStats.emplace_back();
+        ips.push_back(ip);
+        macs.push_back(mac);
+        ap.push_back(apIndex);
+        rates.push_back(rate);
+        sentDl.push_back(0.0);
+        sentDistance.push_back(0.0);
+        ids.push_back(id);
+    }
+};
+
+StaStateTable g_sta; // Per-STA state of this run
+
+// Lean scenario: sink sockets of every STA (DL, slot i) then every AP (UL); null otherwise
+Ptr<SharedByteSink> g_leanSink;
+
+// Returns the bytes received so far by the DL sink of STA i
+uint64_t StaRxBytes(uint32_t i)
+{
+    return g_leanSink ? g_leanSink->GetRx(i) : g_sta.sinks[i]->GetTotalRx();
+}
+
+// Returns the bytes received so far by the UL sink of AP k
+uint64_t ApRxBytes(uint32_t k)
+{
+    return g_leanSink ? g_leanSink->GetRx(g_sta.Size() + k) : g_ap.sinks[k]->GetTotalRx();
+}
 
 // === NS3-AI COMMUNICATION INTERFACE ===
 /*
  * Message interface for bidirectional C++/Python communication:
- * - EnvStruct: WiFi environment data sent to Python
- * - ActStruct: Control actions received from Python
+ * - EnvStruct: WiFi environment data sent to Python (one STA per round trip)
+ * - EnvBatchStruct: All STA records of a report in a single round trip
+ * - CompactBatchStruct: The same report with per-AP fields once and float32 values
+ * - Vector mode: EnvStruct records of g_queueDepth reports per round trip
+ * - ActStruct: Control actions received from Python (per-STA and vector modes)
+ * - ActBatchStruct: The same with per-STA actions (batched modes)
  * - Real-time shared memory communication
  */
-Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct> *msgInterface; // AI message interface
+Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct> *msgInterface = nullptr; // Per-STA interface
+// Batched interface
+Ns3AiMsgInterfaceImpl<EnvBatchStruct, ActBatchStruct> *batchMsgInterface = nullptr;
+// Compact batched interface (wireFormat=compact)
+Ns3AiMsgInterfaceImpl<CompactBatchStruct, ActBatchStruct> *compactMsgInterface = nullptr;
+uint32_t g_vectorReports = 0; // Reports already written into the current vector-mode window
+uint64_t g_reportSeq = 0;     // Sequence number of the current report
+
+// === ASYNCHRONOUS EXCHANGE ===
+/*
+ * State shared between the simulation thread and the async IPC worker thread:
+ * - The simulation queues each report and never waits for Python
+ * - The worker performs the blocking batched handshake for queued reports
+ * - Replies are tagged with the report they answer and applied g_actionLatency
+ *   reports later (or as soon as they arrive if Python lags further behind)
+ * - At most g_actionLatency + 1 reports wait; a new one drops the oldest, so a
+ *   slow peer gets the newest state and the queue stays bounded
+ */
+using AsyncReport = std::pair<uint64_t, std::vector<EnvStruct>>; // (report seq, STA records)
+using AsyncAction = std::pair<uint64_t, ActBatchStruct>;          // (report seq, reply)
+
+struct AsyncExchangeState
+{
+    std::mutex mutex;                // Protects all members below
+    std::condition_variable cv;      // Signals new reports or shutdown
+    std::deque<AsyncReport> reports; // Reports waiting to be sent
+    std::deque<AsyncAction> actions; // Received replies
+    uint64_t dropped = 0;            // Reports dropped from a full queue
+    bool stop = false;               // Set once the simulation has ended
+    std::thread worker;              // IPC worker thread
+    ReportProfiler profiler;         // IPC timings (used by the worker only)
+};
+
+AsyncExchangeState g_async; // Async mode exchange state
+
+// === SHARED-MEMORY RINGS ===
+/*
+ * In ring mode the records bypass ns3-ai (see wifi_shm_ring.h):
+ * - Every report is written in place into the telemetry ring and published at
+ *   once; the simulation only waits if the controller is a whole ring behind
+ * - The controller (reader 0) writes its actions into the action ring, and
+ *   each report applies the newest action that has arrived since the last one
+ * - Further readers (e.g. a dashboard) observe the telemetry without slowing
+ *   the simulation
+ */
+constexpr uint32_t RING_ACTION_SLOTS = 16; // Actions buffered until the next report
+uint32_t g_ringSlots = 16384;              // Telemetry ring capacity (records, a power of two)
+ShmRingSegment g_ring;                     // Telemetry and action rings
+
+// === TELEMETRY-ONLY MODE ===
+/*
+ * Without a Python peer the records are written to a binary columnar log
+ * and the AP Tx power is chosen by a native controller.
+ */
+std::string g_telemetryFile = "wifi_telemetry.bin"; // Telemetry log path
+TelemetryLogWriter g_telemetryLog;                  // Binary telemetry log writer
+
+// === CHANNEL TRACES ===
+/*
+ * traceRecord samples every node position and link gain into a channel trace
+ * (layout in wifi_channel_trace.h). traceReplay moves the nodes and sets every
+ * link gain from such a trace instead of the random walk and the loss models,
+ * so runs of different policies see identical conditions.
+ */
+std::string g_traceRecord; // Channel trace to record ("" disables)
+std::string g_traceReplay; // Channel trace to replay ("" disables)
+double g_traceStep = 0.0;  // Recording: time between two samples (s), 0: interval
+
+struct ChannelTraceState
+{
+    ChannelTraceWriter writer;                // Recording: trace being written
+    ChannelTraceReader reader;                // Replay: mapped trace
+    Ptr<PropagationLossModel> sampler;        // Recording: loss chain drawn per pair and sample
+    Ptr<SampledLossModel> channel;            // Recording: sampled gains seen by the PHYs
+    double step = 0.0;                        // Recording: time between two samples (s)
+    std::vector<Ptr<MobilityModel>> mobility; // Recording: APs, then STAs
+    std::vector<float> positions;             // Recording: positions of the current sample
+    std::vector<float> gains;                 // Recording: link gains of the current sample
+};
+
+ChannelTraceState g_trace; // Channel trace of this run
+
+// Warm start: RNG stream of the recording's fading, below the device and mobility streams
+constexpr int64_t TRACE_FADING_STREAM = 999;
+
+// === NATIVE AP TX POWER CONTROL ===
+/*
+ * With a native controller the AP Tx power is decided in C++ every report,
+ * by one controller instance per AP fed with the measurements of its BSS;
+ * Python (if connected) still receives the telemetry but its reply is ignored.
+ */
+std::string g_controller = "python";        // python, linear, hysteresis or pid
+TxPowerControllerConfig g_controllerConfig; // Native controller tunables
+std::vector<std::unique_ptr<TxPowerController>> g_txControllers; // Per AP (empty: use Python)
+
+// === WALL-CLOCK PROFILING ===
+/*
+ * Per-phase wall time of every GetReport() call (see wifi_profiler.h),
+ * summarized at the end of the run when --profile is set.
+ */
+bool g_profile = false;    // Record and print per-report phase timings
+ReportProfiler g_profiler; // Phase timings of the simulation thread
+
+// === BENCHMARK RECORDS ===
+/*
+ * One JSON line of run metrics (events/s, simulated s per wall s, IPC round
+ * trip percentiles, peak RSS) appended at the end of the run, collected by
+ * wifi_benchmark.py. Timing is enabled as for --profile.
+ */
+std::string g_benchmarkFile; // JSON Lines file the run's record is appended to ("" disables)
+uint64_t g_scenarioBytes = 0; // Resident memory added by InitializeScenario() (bytes)
+
+// === CHANGE-DRIVEN REPORTING ===
+/*
+ * With reportMode=change GetReport() still samples every check interval but
+ * only sends (or logs) a report when ReportTriggered() fires; a skipped check
+ * leaves the Tx power and the native controllers untouched. With maxInterval
+ * the checks of a quiet run are spaced out up to maxInterval.
+ */
+uint64_t g_reportChecks = 0;   // GetReport() calls, sent or skipped
+double g_lastSentReport = 0.0; // Simulation time of the last sent report (s)
+
+// === SPATIAL PARTITIONS ===
+/*
+ * With partitionRange > 0 the APs are grouped into partitions that cannot
+ * hear each other (see wifi_partition.h) and the partitions are spread over
+ * up to partitionProcs processes, each running its own ns-3 simulation:
+ * - The coordinator (rank 0) owns the Python interface and the telemetry log
+ * - Every report, the workers send their STA records to the coordinator, which
+ *   exchanges all of them in one batch and sends the reply back
+ * - State tables hold only the local APs and STAs; ids map them to the global
+ *   indices used in the records and actions
+ */
+double g_partitionRange = 0.0;        // Smallest gap between partition areas (m), 0: one process
+uint32_t g_partitionProcs = 0;        // Most processes of a partitioned run, 0: one per partition
+uint32_t g_rank = 0;                  // Process rank (0: coordinator)
+uint32_t g_ranks = 1;                 // Processes of this run
+std::vector<uint32_t> g_localAps;     // Global indices of the APs simulated by this process
+std::vector<uint32_t> g_apPartition;  // Partition of every AP (empty: one partition)
+std::vector<PartitionLink> g_workers; // Coordinator: link to each worker, rank 1 first
+std::vector<pid_t> g_workerPids;      // Coordinator: process id of each worker
+PartitionLink g_coordinator;          // Worker: link to the coordinator
+
+/**
+ * @struct PartitionRecord
+ * @brief STA record sent from a partition to the coordinator
+ */
+struct PartitionRecord
+{
+    EnvStruct env;  // Record as it would be sent to Python
+    double setApTx; // Native controller choice for the record's AP (telemetry log)
+};
 
 // === NETWORK LAYER INTERFACES ===
 /*
@@ -109,362 +505,2327 @@ Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct> *msgInterface; // AI message interfa
  * - Separate interfaces for AP and stations
  * - Enables bidirectional traffic flow measurement
  */
-Ipv4InterfaceContainer g_apIf;  // IPv4 interface for AP
+Ipv4InterfaceContainer g_apIf;  // IPv4 interfaces for APs
 Ipv4InterfaceContainer g_staIf; // IPv4 interfaces for stations
 
 // === PERFORMANCE MONITORING AND PHY LAYER ===
 /*
  * Physical layer monitoring for performance analysis:
- * - Track packet drops for performance analysis
- * - PHY layer access for transmission parameter control
- * - Real-time throughput measurement
+ * - PhyRxDrop/PhyTxDrop count dropped frames per node
+ * - MonitorSnifferRx accumulates the signal and SNR of decoded frames
+ * - Every sink receives its node's PhyCounters as a bound argument
+ */
+void PhyRxDropSink(PhyCounters *counters, Ptr<const Packet>, WifiPhyRxfailureReason)
+{
+    ++counters->rxDrops;
+}
+
+void PhyTxDropSink(PhyCounters *counters, Ptr<const Packet>)
+{
+    ++counters->txDrops;
+}
+
+// MonitorSnifferRx sink; its signature is taken from WifiPhy::MonitorSnifferRxCallback so
+// only the SignalNoiseDbm argument is inspected, whatever the other arguments are
+template <typename Signature>
+struct SnifferRxSink;
+
+template <typename... Args>
+struct SnifferRxSink<void (*)(Ptr<const Packet>, Args...)>
+{
+    static void Rx(PhyCounters *counters, Ptr<const Packet>, Args... args)
+    {
+        ++counters->rxFrames;
+        (Take(counters, args), ...);
+    }
+
+    static void Take(PhyCounters *counters, const SignalNoiseDbm &signalNoise)
+    {
+        counters->rssiSum += signalNoise.signal;
+        counters->snrSum += signalNoise.signal - signalNoise.noise;
+    }
+
+    template <typename T>
+    static void Take(PhyCounters *, const T &)
+    {
+    }
+};
+
+// Connects the PHY trace sinks of one node to its counters (which must not move afterwards)
+void ConnectPhyTraces(Ptr<YansWifiPhy> phy, PhyCounters *counters)
+{
+    phy->TraceConnectWithoutContext("PhyRxDrop", MakeBoundCallback(&PhyRxDropSink, counters));
+    phy->TraceConnectWithoutContext("PhyTxDrop", MakeBoundCallback(&PhyTxDropSink, counters));
+    phy->TraceConnectWithoutContext(
+        "MonitorSnifferRx",
+        MakeBoundCallback(&SnifferRxSink<WifiPhy::MonitorSnifferRxCallback>::Rx, counters));
+}
+
+// === ASSOCIATION TRACKING ===
+/*
+ * First association time of every STA (StaWifiMac "Assoc" trace), so the run
+ * can report when the last STA joined its BSS, i.e. how much of the time before
+ * the traffic start was actually needed for warm-up.
+ */
+std::vector<bool> g_staAssociated; // Whether each STA has associated at least once
+uint32_t g_associatedStas = 0;     // STAs that have associated at least once
+Time g_lastAssociation;            // Time of the last first association
+
+void StaAssocSink(uint32_t staIndex, Mac48Address)
+{
+    if (g_staAssociated[staIndex])
+    {
+        return;
+    }
+    g_staAssociated[staIndex] = true;
+    ++g_associatedStas;
+    g_lastAssociation = Simulator::Now();
+}
+
+// Returns the start time of the traffic sources (trafficStart, or its default)
+double TrafficStartTime()
+{
+    if (g_config.trafficStart >= 0.0)
+    {
+        return g_config.trafficStart;
+    }
+    return g_config.warmStart ? 0.05 : g_config.interval;
+}
+
+// === FLOW MONITOR STATISTICS ===
+/*
+ * With --flowMonitor every node runs FlowMonitor and each report carries the
+ * delay, jitter and loss of every STA's DL and UL flow over the report interval:
+ * - Flows are mapped to their STA (and direction) once, on first sight
+ * - Only the cumulative counters of the previous report are kept per flow
  */
-std::vector<uint32_t> g_staPhyRxDrops;   // Per-STA PHY RX drop counter
-uint32_t g_apPhyRxDrops = 0;             // AP PHY RX drop counter
-std::vector<Ptr<YansWifiPhy>> g_staPhys; // PHY pointers for stations
-Ptr<YansWifiPhy> g_apPhy;                // PHY pointer for AP
+struct StaFlowStats
+{
+    double dl_delay = 0.0;  // Mean DL one-way delay (ms), 0 without received packets
+    double dl_jitter = 0.0; // Mean DL delay variation between packets (ms)
+    double dl_loss = 0.0;   // DL packets sent but not received in the interval (fraction)
+    double ul_delay = 0.0;  // Mean UL one-way delay (ms)
+    double ul_jitter = 0.0; // Mean UL delay variation between packets (ms)
+    double ul_loss = 0.0;   // UL packets sent but not received in the interval (fraction)
+};
+
+struct FlowStatsTable
+{
+    // Cumulative counters of one flow at the previous report
+    struct FlowSlot
+    {
+        uint32_t sta;       // STA the flow belongs to (UINT32_MAX: not a STA flow)
+        bool uplink;        // STA → AP flow
+        uint32_t txPackets; // Packets sent
+        uint32_t rxPackets; // Packets received
+        Time delaySum;      // Sum of the one-way delays
+        Time jitterSum;     // Sum of the delay variations
+    };
+
+    FlowMonitorHelper helper;                       // Owns the monitor and classifier
+    Ptr<FlowMonitor> monitor;                       // Null unless --flowMonitor is set
+    Ptr<Ipv4FlowClassifier> classifier;             // Maps flow ids to five-tuples
+    std::unordered_map<FlowId, FlowSlot> slots;     // Per-flow previous counters
+    std::unordered_map<uint32_t, uint32_t> staByIp; // STA index by IPv4 address
+    std::vector<StaFlowStats> interval;             // Per-STA stats of the current report
+
+    // Computes `interval` from the counter deltas since the previous report
+    void Update()
+    {
+        interval.assign(g_sta.Size(), StaFlowStats());
+        for (const auto &[id, flow] : monitor->GetFlowStats())
+        {
+            auto it = slots.find(id);
+            if (it == slots.end())
+            {
+                Ipv4FlowClassifier::FiveTuple tuple = classifier->FindFlow(id);
+                auto dst = staByIp.find(tuple.destinationAddress.Get());
+                auto src = staByIp.find(tuple.sourceAddress.Get());
+                FlowSlot slot{UINT32_MAX, false, 0, 0, Time(), Time()};
+                if (dst != staByIp.end())
+                {
+                    slot.sta = dst->second;
+                }
+                else if (src != staByIp.end())
+                {
+                    slot.sta = src->second;
+                    slot.uplink = true;
+                }
+                it = slots.emplace(id, slot).first;
+            }
+            FlowSlot &slot = it->second;
+            if (slot.sta == UINT32_MAX)
+            {
+                continue;
+            }
 
-// Exchanges information with Python AI via the message interface and returns the new AP Tx power
-double
+            uint32_t tx = flow.txPackets - slot.txPackets;
+            uint32_t rx = flow.rxPackets - slot.rxPackets;
+            double delay = rx ? (flow.delaySum - slot.delaySum).GetSeconds() * 1e3 / rx : 0.0;
+            // jitterSum grows by one delay variation per pair of consecutive received packets,
+            // rxPackets - 1 pairs since the start, as in FlowMonitor's own mean jitter
+            uint32_t pairs = (flow.rxPackets ? flow.rxPackets - 1 : 0) -
+                             (slot.rxPackets ? slot.rxPackets - 1 : 0);
+            double jitter =
+                pairs ? (flow.jitterSum - slot.jitterSum).GetSeconds() * 1e3 / pairs : 0.0;
+            double loss = tx > rx ? static_cast<double>(tx - rx) / tx : 0.0;
+            StaFlowStats &sta = interval[slot.sta];
+            (slot.uplink ? sta.ul_delay : sta.dl_delay) = delay;
+            (slot.uplink ? sta.ul_jitter : sta.dl_jitter) = jitter;
+            (slot.uplink ? sta.ul_loss : sta.dl_loss) = loss;
+
+            slot.txPackets = flow.txPackets;
+            slot.rxPackets = flow.rxPackets;
+            slot.delaySum = flow.delaySum;
+            slot.jitterSum = flow.jitterSum;
+        }
+    }
+};
+
+bool g_flowStats = false; // Install FlowMonitor and report per-STA delay, jitter and loss
+FlowStatsTable g_flows;   // FlowMonitor state of this run
+
+// Populates one environment record with the current STA information
+void FillEnvStruct(EnvStruct *env,
+                   double pos_x,
+                   double pos_y,
+                   double distance,
+                   double dl_tp,
+                   double ul_tp,
+                   double get_ApTx,
+                   int sta_id,
+                   int ap_id,
+                   double now_sec,
+                   const StaFlowStats &flows,
+                   const PhyCounters &phy,
+                   uint32_t ap_rx_drops)
+{
+    env->env_pos_x = pos_x;
+    env->env_pos_y = pos_y;
+    env->env_distance = distance;
+    env->env_dl_tp = dl_tp;
+    env->env_ul_tp = ul_tp;
+    env->env_get_ApTx = get_ApTx;
+    env->env_sta_id = sta_id;
+    env->env_ap_id = ap_id;
+    env->env_now_sec = now_sec;
+    env->env_dl_delay = flows.dl_delay;
+    env->env_dl_jitter = flows.dl_jitter;
+    env->env_dl_loss = flows.dl_loss;
+    env->env_ul_delay = flows.ul_delay;
+    env->env_ul_jitter = flows.ul_jitter;
+    env->env_ul_loss = flows.ul_loss;
+    env->env_rx_frames = phy.rxFrames;
+    env->env_rx_drops = phy.rxDrops;
+    env->env_tx_drops = phy.txDrops;
+    env->env_ap_rx_drops = ap_rx_drops;
+    env->env_rssi = phy.rxFrames ? phy.rssiSum / phy.rxFrames : 0.0;
+    env->env_snr = phy.rxFrames ? phy.snrSum / phy.rxFrames : 0.0;
+}
+
+// Populates one compact STA record (per-report and per-AP fields go into the header and aps)
+void FillCompactStaRecord(CompactStaRecord *sta,
+                          const Vector &pos,
+                          double dl_tp,
+                          uint32_t sta_id,
+                          uint32_t ap_id,
+                          const StaFlowStats &flows,
+                          const PhyCounters &phy)
+{
+    sta->pos_x = pos.x;
+    sta->pos_y = pos.y;
+    sta->dl_tp = dl_tp;
+    sta->dl_delay = flows.dl_delay;
+    sta->dl_jitter = flows.dl_jitter;
+    sta->dl_loss = flows.dl_loss;
+    sta->ul_delay = flows.ul_delay;
+    sta->ul_jitter = flows.ul_jitter;
+    sta->ul_loss = flows.ul_loss;
+    sta->rssi = phy.rxFrames ? phy.rssiSum / phy.rxFrames : 0.0;
+    sta->snr = phy.rxFrames ? phy.snrSum / phy.rxFrames : 0.0;
+    sta->rx_frames = phy.rxFrames;
+    sta->rx_drops = phy.rxDrops;
+    sta->tx_drops = phy.txDrops;
+    sta->sta_id = sta_id;
+    sta->ap_id = ap_id;
+    sta->reserved = 0;
+}
+
+// Exchanges information with Python AI via the message interface and returns its action
+ActStruct
 LetsTalk(Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct> *msgInterface,
          double pos_x,
          double pos_y,
          double distance,
          double dl_tp,
          double ul_tp,
-         int get_ApTx,
+         double get_ApTx,
          int sta_id,
-         double now_sec)
+         int ap_id,
+         double now_sec,
+         const StaFlowStats &flows,
+         const PhyCounters &phy,
+         uint32_t ap_rx_drops,
+         ReportProfiler *profiler)
 {
-    std::cout << "C++;LetsTalk: Starting sending msg.\n";
+    NS_LOG_DEBUG("C++;LetsTalk: Starting sending msg.");
+    ProfileScope send(profiler, PROFILE_IPC_SEND);
     msgInterface->CppSendBegin();
 
     // Populate the shared struct with environment information
-    EnvStruct *env = msgInterface->GetCpp2PyStruct();
-    env->env_pos_x = pos_x;
-    env->env_pos_y = pos_y;
-    env->env_distance = distance;
-    env->env_dl_tp = dl_tp;
-    env->env_ul_tp = ul_tp;
-    env->env_get_ApTx = get_ApTx;
-    env->env_sta_id = sta_id;
-    env->env_now_sec = now_sec;
+    FillEnvStruct(msgInterface->GetCpp2PyStruct(),
+                  pos_x,
+                  pos_y,
+                  distance,
+                  dl_tp,
+                  ul_tp,
+                  get_ApTx,
+                  sta_id,
+                  ap_id,
+                  now_sec,
+                  flows,
+                  phy,
+                  ap_rx_drops);
 
     msgInterface->CppSendEnd();
-    std::cout << "C++;LetsTalk: Stopped sending msg.\n";
+    send.Stop();
+    NS_LOG_DEBUG("C++;LetsTalk: Stopped sending msg.");
 
     // Wait for and receive the result from Python
-    std::cout << "C++;LetsTalk: Starting receiving msg.\n";
+    NS_LOG_DEBUG("C++;LetsTalk: Starting receiving msg.");
+    ProfileScope wait(profiler, PROFILE_IPC_WAIT);
     msgInterface->CppRecvBegin();
-    std::cout << "C++;LetsTalk: Started receiving msg.\n";
+    wait.Stop();
+    NS_LOG_DEBUG("C++;LetsTalk: Started receiving msg.");
 
-    // Retrieve the output value set by Python
-    std::cout << "C++;LetsTalk: Got msg.\n";
-    double py_output = msgInterface->GetPy2CppStruct()->env_set_ApTx;
+    // Retrieve the action set by Python
+    NS_LOG_DEBUG("C++;LetsTalk: Got msg.");
+    ActStruct py_output = *msgInterface->GetPy2CppStruct();
 
     msgInterface->CppRecvEnd();
-    std::cout << "C++;LetsTalk: End receiving msg.\n";
+    NS_LOG_DEBUG("C++;LetsTalk: End receiving msg.");
 
     return py_output;
 }
 
-// Initializes the AI message interface for communication with Python
-Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct> *
-InitializeNs3AiInterface()
+// Locks the shared batch struct for writing and resets its record count
+EnvBatchStruct *
+BeginBatchReport(Ns3AiMsgInterfaceImpl<EnvBatchStruct, ActBatchStruct> *batchInterface,
+                 ReportProfiler *profiler)
 {
-    std::cout << "C++;InitializeNs3AiInterface: Initializing the interface.\n";
-    auto interface = Ns3AiMsgInterface::Get();
-    interface->SetIsMemoryCreator(false); // This process does not create shared memory
-    interface->SetUseVector(false);       // Not using vectorized communication
-    interface->SetHandleFinish(true);     // Handle finish signal
-    std::cout << "C++;InitializeNs3AiInterface: The interface has been initialized.\n";
-    return interface->GetInterface<EnvStruct, ActStruct>();
+    NS_LOG_DEBUG("C++;BeginBatchReport: Starting sending batch.");
+    ProfileScope send(profiler, PROFILE_IPC_SEND);
+    batchInterface->CppSendBegin();
+    EnvBatchStruct *batch = batchInterface->GetCpp2PyStruct();
+    batch->env_count = 0;
+    return batch;
 }
 
-// Reports throughput, distance, and energy for each STA and AP, and interacts with AI for AP Tx
-// power
-void GetReport(Time interval)
+// Locks the shared compact batch for writing and fills its header and per-AP records
+CompactBatchStruct *
+BeginCompactReport(Ns3AiMsgInterfaceImpl<CompactBatchStruct, ActBatchStruct> *compactInterface,
+                   double nowSeconds,
+                   const std::vector<Vector> &apPos,
+                   const std::vector<double> &txPower,
+                   const std::vector<double> &ulThroughput,
+                   const std::vector<uint32_t> &apRxDrops,
+                   ReportProfiler *profiler)
 {
-    if (!g_apPhy)
-    {
-        std::cerr << "AP PHY pointer is null at report time!" << std::endl;
-    }
-    if (apDevice.GetN() == 0)
+    NS_LOG_DEBUG("C++;BeginCompactReport: Starting sending compact batch.");
+    ProfileScope send(profiler, PROFILE_IPC_SEND);
+    compactInterface->CppSendBegin();
+    CompactBatchStruct *batch = compactInterface->GetCpp2PyStruct();
+    batch->header = {WIFI_COMPACT_VERSION,
+                     sizeof(CompactApRecord),
+                     sizeof(CompactStaRecord),
+                     static_cast<uint16_t>(apPos.size()),
+                     0,
+                     0,
+                     nowSeconds};
+    for (uint32_t k = 0; k < apPos.size(); ++k)
     {
-        std::cerr << "apDevice is empty!" << std::endl;
+        batch->aps[k] = {static_cast<float>(apPos[k].x),
+                         static_cast<float>(apPos[k].y),
+                         static_cast<float>(txPower[k]),
+                         static_cast<float>(ulThroughput[k]),
+                         apRxDrops[k]};
     }
+    return batch;
+}
+
+// Copies an action out of shared memory: the per-AP fields and the valid per-STA entries only
+void CopyBatchAction(const ActBatchStruct &from, ActBatchStruct &to)
+{
+    static_cast<ActStruct &>(to) = from;
+    to.act_sta_count = std::min(from.act_sta_count, WIFI_MAX_BATCH_STAS);
+    std::copy_n(from.act_sta_mcs, to.act_sta_count, to.act_sta_mcs);
+    std::copy_n(from.act_sta_txPower, to.act_sta_count, to.act_sta_txPower);
+}
+
+// Publishes the filled batch (full or compact) to Python and returns its reply
+template <typename BatchStruct>
+ActBatchStruct
+EndBatchReport(Ns3AiMsgInterfaceImpl<BatchStruct, ActBatchStruct> *batchInterface,
+               ReportProfiler *profiler)
+{
+    ProfileScope send(profiler, PROFILE_IPC_SEND);
+    batchInterface->CppSendEnd();
+    send.Stop();
+    NS_LOG_DEBUG("C++;EndBatchReport: Stopped sending batch.");
+
+    // Wait for the single reply covering the whole report
+    ProfileScope wait(profiler, PROFILE_IPC_WAIT);
+    batchInterface->CppRecvBegin();
+    wait.Stop();
+    ActBatchStruct py_output;
+    CopyBatchAction(*batchInterface->GetPy2CppStruct(), py_output);
+    batchInterface->CppRecvEnd();
+    NS_LOG_DEBUG("C++;EndBatchReport: End receiving msg.");
 
-    // Get AP device, SSID, and position
-    Ptr<WifiNetDevice> apDev = DynamicCast<WifiNetDevice>(apDevice.Get(0));
-    Ssid apSsid = apDev->GetMac()->GetSsid();
-    Vector apPos = g_apMobility->GetPosition();
+    return py_output;
+}
 
-    // Retrieve current AP Tx power
-    double old_txPower = 20.0;
-    double new_txPower = 20.0;
-    if (g_apPhy)
+// Returns the shared vector to write the current report into, opening a new window if needed
+Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct>::Cpp2PyMsgVector *
+BeginVectorReport(Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct> *vectorInterface,
+                  ReportProfiler *profiler)
+{
+    if (g_vectorReports == 0)
     {
-        old_txPower = g_apPhy->GetTxPowerStart();
-        new_txPower = old_txPower;
+        // The vector stays locked while the simulation runs ahead for g_queueDepth reports
+        NS_LOG_DEBUG("C++;BeginVectorReport: Starting sending vector window.");
+        ProfileScope send(profiler, PROFILE_IPC_SEND);
+        vectorInterface->CppSendBegin();
+        NS_ABORT_MSG_IF(vectorInterface->GetCpp2PyVector()->size() < g_queueDepth * g_config.nStas,
+                        "Shared EnvStruct vector holds "
+                            << vectorInterface->GetCpp2PyVector()->size()
+                            << " records, vector mode needs queueDepth * nStas = "
+                            << g_queueDepth * g_config.nStas);
     }
-    else
+    return vectorInterface->GetCpp2PyVector();
+}
+
+// Publishes the buffered reports to Python and returns its reply
+ActStruct
+EndVectorReport(Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct> *vectorInterface,
+                ReportProfiler *profiler)
+{
+    ProfileScope send(profiler, PROFILE_IPC_SEND);
+    // Mark the unused slots of a partially filled (final) window as invalid
+    auto envVector = vectorInterface->GetCpp2PyVector();
+    for (uint32_t k = g_vectorReports * g_config.nStas; k < envVector->size(); ++k)
     {
-        std::cerr << "AP PHY pointer is null at report time!\n";
+        envVector->at(k).env_sta_id = -1;
     }
 
-    // Get current simulation time
-    Time now = Simulator::Now();
-    double nowSeconds = now.GetSeconds();
+    vectorInterface->CppSendEnd();
+    send.Stop();
+    NS_LOG_DEBUG("C++;EndVectorReport: Stopped sending " << g_vectorReports << " reports.");
+    g_vectorReports = 0;
 
-    // Print AP information and simulation time
-    std::cout << "\n=== Report @ " << nowSeconds << "s ==="
-              << "\nAP SSID: " << apSsid << "\nAP Position: (" << apPos.x << ", " << apPos.y
-              << ")\n";
+    // Python answers with a single action in the first slot of its vector
+    ProfileScope wait(profiler, PROFILE_IPC_WAIT);
+    vectorInterface->CppRecvBegin();
+    wait.Stop();
+    ActStruct py_output = vectorInterface->GetPy2CppVector()->at(0);
+    vectorInterface->CppRecvEnd();
+    NS_LOG_DEBUG("C++;EndVectorReport: End receiving msg.");
 
-    // Print total uplink throughput for AP
-    uint64_t curApRx = g_apServer->GetReceived();
-    double ulThroughput = (curApRx - g_lastApRx) * 1472 * 8.0 / 1e6;
-    g_lastApRx = curApRx;
-    std::cout << "Total UL Throughput: " << ulThroughput << "Mbps\n";
+    return py_output;
+}
 
-    // For each STA, print position, distance to AP, downlink throughput, and energy info
-    for (uint32_t i = 0; i < g_staServers.size(); ++i)
+// Async IPC worker: sends queued reports to Python one batch at a time and collects replies
+void AsyncExchangeWorker()
+{
+    while (true)
     {
-        Ptr<WifiNetDevice> staDev = DynamicCast<WifiNetDevice>(staDevices.Get(i));
-        Ptr<YansWifiPhy> staPhy = DynamicCast<YansWifiPhy>(staDev->GetPhy());
-        Ipv4Address staIp = g_staIf.GetAddress(i);
-
-        uint64_t curStaRx = g_staServers[i]->GetReceived();
-        double dlThroughput = (curStaRx - g_lastStaRx[i]) * 1472 * 8.0 / 1e6; // Mbps
-        g_lastStaRx[i] = curStaRx;
-
-        Vector staPos = g_staMobility[i]->GetPosition();
-        double distance = g_apMobility->GetDistanceFrom(g_staMobility[i]);
-
-        // Print STA information
-        std::cout << "STA[" << i << "]"
-                  << " IP: " << staIp << " Position: (" << staPos.x << ", " << staPos.y << ")"
-                  << " Distance: " << distance << "m"
-                  << "\n  DL: " << dlThroughput << "Mbps\n";
-
-        // Interact with AI (Python) for new AP Tx power
-        new_txPower = LetsTalk(msgInterface,
-                               staPos.x,
-                               staPos.y,
-                               distance,
-                               dlThroughput,
-                               ulThroughput,
-                               old_txPower,
-                               i,
-                               nowSeconds);
-        std::cout << "C++;GetReport: Python Response TX: " << new_txPower << "\n";
+        AsyncReport report;
+        {
+            std::unique_lock<std::mutex> lock(g_async.mutex);
+            g_async.cv.wait(lock, [] { return g_async.stop || !g_async.reports.empty(); });
+            if (g_async.reports.empty())
+            {
+                break; // Stopped and drained
+            }
+            report = std::move(g_async.reports.front());
+            g_async.reports.pop_front();
+        }
 
-        // Display station performance metrics
-        std::cout << "   [Station " << i << "] "
-                  << "Position: (" << staPos.x << ", " << staPos.y << "), "
-                  << "Distance: " << distance << "m, "
-                  << "DL: " << dlThroughput << "Mbps, "
-                  << "UL: " << ulThroughput << "Mbps\n";
+        g_async.profiler.BeginReport();
+        EnvBatchStruct *batch = BeginBatchReport(batchMsgInterface, &g_async.profiler);
+        for (const EnvStruct &record : report.second)
+        {
+            batch->env_records[batch->env_count++] = record;
+        }
+        ActBatchStruct py_output = EndBatchReport(batchMsgInterface, &g_async.profiler);
+        g_async.profiler.EndReport();
+
+        std::lock_guard<std::mutex> lock(g_async.mutex);
+        g_async.actions.emplace_back(report.first, py_output);
     }
+}
 
-    // Set new AP Tx power using the global pointer (only once per report)
-    if (g_apPhy)
+// Queues a report for the async worker without waiting for Python, dropping the oldest
+// waiting report if g_actionLatency + 1 are already queued
+void PublishAsyncReport(uint64_t seq, std::vector<EnvStruct> records)
+{
     {
-        g_apPhy->SetTxPowerStart(new_txPower);
-        g_apPhy->SetTxPowerEnd(new_txPower);
+        std::lock_guard<std::mutex> lock(g_async.mutex);
+        if (g_async.reports.size() > g_actionLatency)
+        {
+            g_async.reports.pop_front();
+            ++g_async.dropped;
+        }
+        g_async.reports.emplace_back(seq, std::move(records));
     }
-    else
+    g_async.cv.notify_one();
+}
+
+// Returns the most recent reply that is at least g_actionLatency reports old, if any arrived
+std::optional<ActBatchStruct>
+TakeAsyncAction(uint64_t seq)
+{
+    std::optional<ActBatchStruct> action;
+    std::lock_guard<std::mutex> lock(g_async.mutex);
+    while (!g_async.actions.empty() && g_async.actions.front().first + g_actionLatency <= seq)
     {
-        std::cerr << "AP PHY is null, cannot set Tx power!\n";
+        action = g_async.actions.front().second;
+        g_async.actions.pop_front();
     }
+    return action;
+}
 
-    // Schedule the next report if simulation time not exceeded
-    if (Simulator::Now().GetSeconds() + interval.GetSeconds() <= g_totalTime)
+// Applies the per-STA MCS and Tx power actions right away (act_sta_count == 0: none)
+void ApplyStaActions(const ActBatchStruct &action)
+{
+    for (uint32_t i = 0; i < g_sta.Size(); ++i)
     {
-        Simulator::Schedule(interval, &GetReport, interval);
+        uint32_t id = g_sta.ids[i];
+        if (id >= action.act_sta_count)
+        {
+            continue;
+        }
+        uint8_t mcs = action.act_sta_mcs[id];
+        if (mcs != WIFI_MCS_KEEP && g_sta.rates[i])
+        {
+            g_ap.rates[g_sta.ap[i]]->SetPeerMcs(g_sta.macs[i], mcs); // DL
+            g_sta.rates[i]->SetDataMcs(mcs);                         // UL
+        }
+        double txPower = action.act_sta_txPower[id];
+        if (!std::isnan(txPower))
+        {
+            g_sta.phys[i]->SetTxPowerStart(txPower);
+            g_sta.phys[i]->SetTxPowerEnd(txPower);
+        }
     }
 }
 
-// Sets up the WiFi scenario: nodes, devices, mobility, IP, UDP apps
-void InitializeScenario()
+// Applies a Python action to the per-AP Tx powers (act_count == 0: one power for every AP)
+void ApplyAction(const ActStruct &action, std::vector<double> &txPower)
 {
-    using namespace ns3::energy;
-    std::cout << "C++;InitializeScenario: Initializing the scenario.\n";
-
-    // Create AP and STA nodes
-    std::cout << "C++;InitializeScenario: Creating AP and STA nodes.\n";
-    wifiApNode.Create(1);
-    wifiStaNodes.Create(g_nStas);
+    if (action.act_count == 0)
+    {
+        std::fill(txPower.begin(), txPower.end(), action.env_set_ApTx);
+        return;
+    }
+    for (uint32_t k = 0; k < txPower.size(); ++k)
+    {
+        if (g_ap.ids[k] < action.act_count)
+        {
+            txPower[k] = action.act_set_ApTx[g_ap.ids[k]];
+        }
+    }
+}
 
-    // Set up WiFi channel and PHY layer with 1 antenna and 1 spatial stream
-    std::cout << "C++;InitializeScenario: Setting up WiFi channel and PHY layer.\n";
-    YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
-    YansWifiPhyHelper phy;
-    channel.AddPropagationLoss("ns3::LogDistancePropagationLossModel",
-                               "Exponent",
-                               DoubleValue(3.0),
-                               "ReferenceLoss",
-                               DoubleValue(40.0459));
-    channel.AddPropagationLoss("ns3::NakagamiPropagationLossModel",
-                               "m0",
-                               DoubleValue(1.0),
-                               "m1",
-                               DoubleValue(1.0),
-                               "m2",
-                               DoubleValue(1.0));
-    phy.SetChannel(channel.Create());
-    phy.Set("Antennas", UintegerValue(1));
-    phy.Set("MaxSupportedTxSpatialStreams", UintegerValue(1));
-    phy.Set("MaxSupportedRxSpatialStreams", UintegerValue(1));
+// Applies a batched Python action to the per-AP Tx powers and to the STAs
+void ApplyAction(const ActBatchStruct &action, std::vector<double> &txPower)
+{
+    ApplyStaActions(action);
+    ApplyAction(static_cast<const ActStruct &>(action), txPower);
+}
 
-    // Configure MAC and WiFi standard (802.11n), and set rate control
-    std::cout << "C++;InitializeScenario: Configuring MAC and WiFi standard.\n";
-    WifiMacHelper mac;
-    WifiHelper wifi;
-    wifi.SetStandard(WIFI_STANDARD_80211n);
-    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
-                                 "DataMode",
-                                 StringValue("HtMcs1"),
-                                 "ControlMode",
-                                 StringValue("HtMcs0"));
-    Ssid ssid = Ssid("ns3-80211n-mimo");
-
-    // Install STA devices with specified SSID and disable active probing
-    mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid), "ActiveProbing", BooleanValue(false));
-    staDevices = wifi.Install(phy, mac, wifiStaNodes);
-    // when you do something difficult, the labour passes quickly but the pride endures
-    // when you do something shameful for pleasure, the pleasure passes quickly but the shame
-    // endures
-
-    // Install AP device with specified SSID
-    mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
-    apDevice = wifi.Install(phy, mac, wifiApNode);
-
-    // Set global AP PHY pointer for later use
-    Ptr<WifiNetDevice> apDev = DynamicCast<WifiNetDevice>(apDevice.Get(0));
-    g_apPhy = DynamicCast<YansWifiPhy>(apDev->GetPhy());
-
-    // Set up mobility for AP: fixed position at (0,0,0)
-    std::cout << "C++;InitializeScenario: Setting up mobility for AP and STAs.\n";
-    MobilityHelper mobility;
-    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
-    positionAlloc->Add(Vector(0.0, 0.0, 0.0));
-    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-    mobility.SetPositionAllocator(positionAlloc);
-    mobility.Install(wifiApNode);
+// Flushes the remaining reports to Python and joins the async worker
+void StopAsyncExchange()
+{
+    {
+        std::lock_guard<std::mutex> lock(g_async.mutex);
+        g_async.stop = true;
+    }
+    g_async.cv.notify_one();
+    g_async.worker.join();
+}
 
-    // Set up mobility for STAs: random walk within a rectangle, slow speed
-    MobilityHelper staMobility;
-    Ptr<ListPositionAllocator> staPositionAlloc = CreateObject<ListPositionAllocator>();
-    for (uint32_t i = 0; i < g_nStas; ++i)
-    {
-        double angle = (2 * M_PI * i) / g_nStas;
-        double x = g_init_distance * cos(angle);
-        double y = g_init_distance * sin(angle);
-        staPositionAlloc->Add(Vector(x, y, 0.0));
-    }
-    staMobility.SetPositionAllocator(staPositionAlloc);
-    staMobility.SetMobilityModel("ns3::RandomWalk2dMobilityModel",
-                                 "Bounds",
-                                 RectangleValue(Rectangle(-50, 50, -50, 50)),
-                                 "Speed",
-                                 StringValue("ns3::ConstantRandomVariable[Constant=0.05]"));
-    staMobility.Install(wifiStaNodes);
-
-    // Store references to mobility models for AP and STAs
-    g_apMobility = wifiApNode.Get(0)->GetObject<MobilityModel>();
-    g_staMobility.clear();
-    for (uint32_t i = 0; i < g_nStas; ++i)
-    {
-        g_staMobility.push_back(wifiStaNodes.Get(i)->GetObject<MobilityModel>());
-    }
-
-    // Install Internet stack (TCP/IP) on all nodes
-    std::cout << "C++;InitializeScenario: Installing Internet stack on nodes.\n";
-    InternetStackHelper stack;
-    stack.Install(wifiApNode);
-    stack.Install(wifiStaNodes);
-
-    // Assign IP addresses to AP and STA devices
-    Ipv4AddressHelper address;
-    address.SetBase("192.168.1.0", "255.255.255.0");
-    Ipv4InterfaceContainer apIf = address.Assign(apDevice);
-    Ipv4InterfaceContainer staIf = address.Assign(staDevices);
+// Reserves telemetry ring slots for the n records of the current report
+uint64_t
+BeginRingReport(uint32_t n, ReportProfiler *profiler)
+{
+    // Only waits while the controller is a whole ring behind
+    ProfileScope wait(profiler, PROFILE_IPC_WAIT);
+    uint64_t start = 0;
+    NS_ABORT_MSG_IF(!g_ring.Telemetry().Reserve(n, start),
+                    (g_ring.Telemetry().IsReaderAlive(0)
+                         ? "Telemetry ring closed"
+                         : "Controller exited while attached to the telemetry ring"));
+    return start;
+}
 
-    g_apIf = apIf;
-    g_staIf = staIf;
+// Publishes the reserved records and returns the newest action received since the last report
+std::optional<ActBatchStruct>
+EndRingReport(ReportProfiler *profiler)
+{
+    ProfileScope send(profiler, PROFILE_IPC_SEND);
+    g_ring.Telemetry().Publish();
+    send.Stop();
 
-    // Set up UDP servers on each STA and the AP, and track received packets
-    std::cout << "C++;InitializeScenario: Setting up UDP servers on STAs and AP.\n";
-    uint16_t port = 9;
-    g_staServers.clear();
-    g_lastStaRx.clear();
-    for (uint32_t i = 0; i < g_nStas; ++i)
-    {
-        UdpServerHelper staServer(port);
-        ApplicationContainer staServerApp = staServer.Install(wifiStaNodes.Get(i));
-        staServerApp.Start(Seconds(0.0));
-        staServerApp.Stop(Seconds(g_totalTime));
-        g_staServers.push_back(DynamicCast<UdpServer>(staServerApp.Get(0)));
-        g_lastStaRx.push_back(0);
-    }
-    UdpServerHelper apServer(port);
-    ApplicationContainer apServerApp = apServer.Install(wifiApNode.Get(0));
-    apServerApp.Start(Seconds(0.0));
-    apServerApp.Stop(Seconds(g_totalTime));
-    g_apServer = DynamicCast<UdpServer>(apServerApp.Get(0));
-
-    // Set up UDP clients for both downlink (AP→STA) and uplink (STA→AP)
-    ApplicationContainer apToStaApps;
-    ApplicationContainer staToApApps;
-
-    for (uint32_t i = 0; i < g_nStas; ++i)
-    {
-        // Downlink: AP sends to STA[i]
-        UdpClientHelper apToStaClient(staIf.GetAddress(i), port);
-        apToStaClient.SetAttribute("MaxPackets", UintegerValue(4294967295U));
-        apToStaClient.SetAttribute("Interval", TimeValue(MilliSeconds(1)));
-        apToStaClient.SetAttribute("PacketSize", UintegerValue(1472));
-        apToStaApps.Add(apToStaClient.Install(wifiApNode.Get(0)));
-
-        // Uplink: STA[i] sends to AP
-        UdpClientHelper staToApClient(apIf.GetAddress(0), port);
-        staToApClient.SetAttribute("MaxPackets", UintegerValue(4294967295U));
-        staToApClient.SetAttribute("Interval", TimeValue(MilliSeconds(1)));
-        staToApClient.SetAttribute("PacketSize", UintegerValue(1472));
-        staToApApps.Add(staToApClient.Install(wifiStaNodes.Get(i)));
-    }
-    // Start and stop UDP client applications at the correct times
-    apToStaApps.Start(Seconds(g_interval));
-    apToStaApps.Stop(Seconds(g_totalTime));
-    staToApApps.Start(Seconds(g_interval));
-    staToApApps.Stop(Seconds(g_totalTime));
-
-    // Store PHY pointers for each STA for later use
-    for (uint32_t i = 0; i < g_nStas; ++i)
+    std::optional<ActBatchStruct> action;
+    ShmRing &actions = g_ring.Actions();
+    for (RingSpan span = actions.Poll(0); span.count > 0; span = actions.Poll(0))
     {
-        Ptr<WifiNetDevice> staDev = DynamicCast<WifiNetDevice>(staDevices.Get(i));
-        g_staPhys.push_back(DynamicCast<YansWifiPhy>(staDev->GetPhy()));
+        action.emplace();
+        CopyBatchAction(
+            *static_cast<const ActBatchStruct *>(actions.Slot(span.start + span.count - 1)),
+            *action);
+        actions.Release(0, span);
     }
-
-    std::cout << "C++;InitializeScenario: Scenario initialized successfully.\n";
+    return action;
 }
 
-// Main function: entry point for the simulation
-int main(int argc, char *argv[])
+// Initializes the AI message interface for communication with Python
+template <typename Cpp2PyMsgType, typename Py2CppMsgType>
+Ns3AiMsgInterfaceImpl<Cpp2PyMsgType, Py2CppMsgType> *
+InitializeNs3AiInterface(bool useVector)
 {
-    // Initialize the AI message interface for communication with Python
-    msgInterface = InitializeNs3AiInterface();
-
-    // Set up the WiFi scenario (nodes, devices, mobility, IP, UDP apps, etc.)
-    InitializeScenario();
+    NS_LOG_INFO("C++;InitializeNs3AiInterface: Initializing the interface.");
+    auto interface = Ns3AiMsgInterface::Get();
+    interface->SetIsMemoryCreator(false); // This process does not create shared memory
+    interface->SetUseVector(useVector);   // Vector (multi-record) or single-struct communication
+    interface->SetHandleFinish(true);     // Handle finish signal
+    // Shared memory names must match the ones given to ns3ai_utils.Experiment in Python
+    interface->SetNames(g_shmPrefix + " Seg",
+                        g_shmPrefix + " Cpp to Python Msg",
+                        g_shmPrefix + " Python to Cpp Msg",
+                        g_shmPrefix + " Lockable");
+    NS_LOG_INFO("C++;InitializeNs3AiInterface: The interface has been initialized.");
+    return interface->GetInterface<Cpp2PyMsgType, Py2CppMsgType>();
+}
 
-    // Schedule periodic reporting of throughput and distance
-    Simulator::Schedule(Seconds(g_interval), &GetReport, Seconds(g_interval));
+/**
+ * Decides whether the current check sends a report in change-driven mode.
+ * Reads the STA counters of the interval without consuming them.
+ * @param nowSeconds Current simulation time
+ * @param apPos Position of every AP
+ * @param ulThroughput UL throughput of every AP in this interval
+ * @param tpScale Factor normalizing throughput to one base interval
+ * @return true if a STA or AP crossed a threshold or the heartbeat is due
+ */
+bool ReportTriggered(double nowSeconds,
+                     const std::vector<Vector> &apPos,
+                     const std::vector<double> &ulThroughput,
+                     double tpScale)
+{
+    if (g_reportSeq == 0 || nowSeconds - g_lastSentReport >= g_config.maxSilence)
+    {
+        return true;
+    }
+    for (uint32_t k = 0; k < g_ap.Size(); ++k)
+    {
+        if (std::abs(ulThroughput[k] - g_ap.sentUl[k]) >= g_config.tpDelta)
+        {
+            return true;
+        }
+    }
+    for (uint32_t i = 0; i < g_sta.Size(); ++i)
+    {
+        double dl = (StaRxBytes(i) - g_sta.lastRx[i]) * 8.0 / 1e6 * tpScale;
+        double distance =
+            CalculateDistance(apPos[g_sta.ap[i]], g_sta.mobility[i]->GetPosition());
+        const PhyCounters &phy = g_sta.phyStats[i];
+        uint32_t frames = phy.rxFrames + phy.rxDrops;
+        if (std::abs(dl - g_sta.sentDl[i]) >= g_config.tpDelta ||
+            std::abs(distance - g_sta.sentDistance[i]) >= g_config.distanceDelta ||
+            (frames > 0 && phy.rxDrops >= g_config.dropRate * frames))
+        {
+            return true;
+        }
+    }
+    return false;
+}
 
-    // Set simulation stop time and run the simulation
-    Simulator::Stop(Seconds(g_totalTime));
+/**
+ * Interval until the check after a skipped one: doubled up to maxInterval,
+ * but never past the heartbeat or the end of the simulation
+ * @param nowSeconds Current simulation time
+ * @param interval Current check interval
+ * @return Next check interval
+ */
+Time NextCheckInterval(double nowSeconds, Time interval)
+{
+    if (g_config.maxInterval <= g_config.interval)
+    {
+        return interval;
+    }
+    double next = std::min({2.0 * interval.GetSeconds(),
+                            g_config.maxInterval,
+                            g_lastSentReport + g_config.maxSilence - nowSeconds});
+    if (next <= interval.GetSeconds() || nowSeconds + next > g_config.totalTime)
+    {
+        return interval;
+    }
+    return Seconds(next);
+}
+
+/**
+ * Combines the change-driven trigger decisions of all processes of a partitioned run,
+ * so that every partition sends or skips the same reports
+ * @param triggered Decision of this process
+ * @return Whether any process triggered
+ */
+bool PartitionVote(bool triggered)
+{
+    uint8_t vote = triggered;
+    if (g_rank != 0)
+    {
+        NS_ABORT_MSG_IF(!g_coordinator.Write(&vote, sizeof(vote)) ||
+                            !g_coordinator.Read(&vote, sizeof(vote)),
+                        "Partition coordinator closed the link");
+        return vote;
+    }
+    for (const PartitionLink &worker : g_workers)
+    {
+        uint8_t workerVote = 0;
+        NS_ABORT_MSG_IF(!worker.Read(&workerVote, sizeof(workerVote)), "Partition worker exited");
+        vote |= workerVote;
+    }
+    for (const PartitionLink &worker : g_workers)
+    {
+        NS_ABORT_MSG_IF(!worker.Write(&vote, sizeof(vote)), "Partition worker exited");
+    }
+    return vote;
+}
+
+/**
+ * Aggregation step of a partitioned run, called by every process once per report.
+ * The coordinator collects the records of all partitions, writes them to the
+ * telemetry log or exchanges them with Python as one batch, and sends the reply
+ * to every worker.
+ * @param records STA records of this process
+ * @param txPower Per-AP Tx power of this process, updated from the reply
+ * @param nowSeconds Current simulation time
+ */
+void ExchangePartitionReport(const std::vector<PartitionRecord> &records,
+                             std::vector<double> &txPower,
+                             double nowSeconds)
+{
+    ActBatchStruct action{};
+    if (g_rank != 0)
+    {
+        NS_ABORT_MSG_IF(!g_coordinator.WriteVector(records) ||
+                            !g_coordinator.Read(&action, sizeof(action)),
+                        "Partition coordinator closed the link");
+    }
+    else
+    {
+        std::vector<PartitionRecord> all(records);
+        for (const PartitionLink &worker : g_workers)
+        {
+            NS_ABORT_MSG_IF(!worker.AppendVector(all), "Partition worker exited");
+        }
+        // Same record order as a single-process run
+        std::sort(all.begin(), all.end(), [](const PartitionRecord &a, const PartitionRecord &b) {
+            return a.env.env_sta_id < b.env.env_sta_id;
+        });
+
+        if (g_ipcMode == "none")
+        {
+            for (const PartitionRecord &record : all)
+            {
+                g_telemetryLog.Append(record.env, record.setApTx);
+            }
+            g_telemetryLog.Flush();
+        }
+        else
+        {
+            EnvBatchStruct *batch = BeginBatchReport(batchMsgInterface, &g_profiler);
+            for (const PartitionRecord &record : all)
+            {
+                batch->env_records[batch->env_count++] = record.env;
+            }
+            action = EndBatchReport(batchMsgInterface, &g_profiler);
+        }
+        for (const PartitionLink &worker : g_workers)
+        {
+            NS_ABORT_MSG_IF(!worker.Write(&action, sizeof(action)), "Partition worker exited");
+        }
+
+        // Production summary over all partitions: mean DL per STA, UL summed over the APs
+        if (g_verbosity >= 1)
+        {
+            double dlTotal = 0.0;
+            std::vector<double> apUl(g_config.nAps, 0.0);
+            for (const PartitionRecord &record : all)
+            {
+                dlTotal += record.env.env_dl_tp;
+                apUl[record.env.env_ap_id] = record.env.env_ul_tp;
+            }
+            std::cout << "Report @ " << nowSeconds << "s: " << all.size() << " STAs in "
+                      << g_ranks << " processes, mean DL "
+                      << (all.empty() ? 0.0 : dlTotal / all.size()) << "Mbps, UL "
+                      << std::accumulate(apUl.begin(), apUl.end(), 0.0) << "Mbps\n";
+        }
+    }
+    if (g_ipcMode != "none")
+    {
+        ApplyAction(action, txPower);
+    }
+}
+
+// Reports throughput, distance, and energy for each STA and AP, and interacts with AI for AP Tx
+// power
+void GetReport(Time interval)
+{
+    g_profiler.BeginReport();
+    ProfileScope stats(&g_profiler, PROFILE_STATS);
+    ++g_reportChecks;
+
+    // Throughput is reported per base interval, also over stretched check intervals
+    double tpScale = g_config.interval / interval.GetSeconds();
+
+    // Per-AP position, Tx power and UL throughput (all handles are cached at setup)
+    uint32_t nAps = g_ap.Size();
+    std::vector<Vector> apPos(nAps);
+    std::vector<double> old_txPower(nAps);
+    std::vector<double> ulThroughput(nAps);
+    std::vector<uint32_t> apRxDrops(nAps);
+    for (uint32_t k = 0; k < nAps; ++k)
+    {
+        apRxDrops[k] = g_ap.phyStats[k].rxDrops;
+        g_ap.phyStats[k] = PhyCounters();
+        apPos[k] = g_ap.mobility[k]->GetPosition();
+        old_txPower[k] = g_ap.phys[k]->GetTxPowerStart();
+        uint64_t curApRx = ApRxBytes(k);
+        ulThroughput[k] = (curApRx - g_ap.lastRx[k]) * 8.0 / 1e6 * tpScale;
+        g_ap.lastRx[k] = curApRx;
+    }
+    std::vector<double> new_txPower = old_txPower;
+
+    // Per-STA delay, jitter and loss since the previous report
+    static const StaFlowStats noFlowStats;
+    if (g_flows.monitor)
+    {
+        g_flows.Update();
+    }
+
+    // Get current simulation time
+    Time now = Simulator::Now();
+    double nowSeconds = now.GetSeconds();
+
+    // Is this the last report of the simulation?
+    bool lastReport = nowSeconds + interval.GetSeconds() > g_config.totalTime;
+
+    // Change-driven mode: skip quiet checks (the last report is always sent)
+    bool partitioned = g_ranks > 1;
+    bool skip = false;
+    if (g_config.reportMode == "change" && !lastReport)
+    {
+        bool triggered = ReportTriggered(nowSeconds, apPos, ulThroughput, tpScale);
+        skip = !(partitioned ? PartitionVote(triggered) : triggered);
+    }
+    if (skip)
+    {
+        for (uint32_t i = 0; i < g_sta.Size(); ++i)
+        {
+            g_sta.lastRx[i] = StaRxBytes(i);
+            g_sta.phyStats[i] = PhyCounters();
+        }
+        stats.Stop();
+        g_profiler.EndReport();
+        Time next = NextCheckInterval(nowSeconds, interval);
+        Simulator::Schedule(next, &GetReport, next);
+        return;
+    }
+    stats.Stop();
+
+    // Print AP information and simulation time
+    for (uint32_t k = 0; k < nAps; ++k)
+    {
+        NS_LOG_INFO("=== Report @ " << nowSeconds << "s === AP[" << k << "] SSID: "
+                                    << g_ap.ssids[k] << " Position: (" << apPos[k].x << ", "
+                                    << apPos[k].y << ") UL Throughput: " << ulThroughput[k]
+                                    << "Mbps");
+    }
+
+    // Native controllers decide before the loop so the records can carry their choice
+    ProfileScope decide(&g_profiler, PROFILE_TX_UPDATE);
+    std::vector<double> controllerTxPower = old_txPower;
+    for (uint32_t k = 0; k < g_txControllers.size(); ++k)
+    {
+        controllerTxPower[k] = g_txControllers[k]->Decide(old_txPower[k]);
+    }
+    decide.Stop();
+    std::vector<double> dlSum(nAps, 0.0);
+    std::vector<uint32_t> bssStas(nAps, 0);
+
+    // Without a Python peer the records go to the telemetry log
+    bool telemetryOnly = g_ipcMode == "none";
+
+    // In async mode records are collected locally and queued for the IPC worker thread
+    bool asyncMode = g_ipcMode == "async";
+    std::vector<EnvStruct> asyncRecords;
+
+    // In a partitioned run records are collected locally and aggregated by the coordinator
+    std::vector<PartitionRecord> partitionRecords;
+
+    // In ring mode the records are written straight into reserved telemetry ring slots
+    bool ringMode = g_ipcMode == "ring";
+    uint64_t ringStart = ringMode ? BeginRingReport(g_sta.Size(), &g_profiler) : 0;
+
+    // In batch mode all STA records go into one shared struct, exchanged after the loop
+    EnvBatchStruct *batch = batchMsgInterface && !asyncMode && !partitioned
+                                ? BeginBatchReport(batchMsgInterface, &g_profiler)
+                                : nullptr;
+    CompactBatchStruct *compact = compactMsgInterface ? BeginCompactReport(compactMsgInterface,
+                                                                           nowSeconds,
+                                                                           apPos,
+                                                                           old_txPower,
+                                                                           ulThroughput,
+                                                                           apRxDrops,
+                                                                           &g_profiler)
+                                                      : nullptr;
+
+    // In vector mode records of several reports go into the shared vector before one exchange
+    Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct>::Cpp2PyMsgVector *envVector =
+        g_ipcMode == "vector" ? BeginVectorReport(msgInterface, &g_profiler) : nullptr;
+
+    // For each STA, print position, distance to AP, downlink throughput, and energy info
+    uint32_t nStas = g_sta.Size();
+    for (uint32_t i = 0; i < nStas; ++i)
+    {
+        ProfileScope staStats(&g_profiler, PROFILE_STATS);
+        uint32_t k = g_sta.ap[i];
+        uint64_t curStaRx = StaRxBytes(i);
+        double dlThroughput = (curStaRx - g_sta.lastRx[i]) * 8.0 / 1e6 * tpScale; // Mbps
+        g_sta.lastRx[i] = curStaRx;
+        dlSum[k] += dlThroughput;
+        ++bssStas[k];
+
+        Vector staPos = g_sta.mobility[i]->GetPosition();
+        double distance = CalculateDistance(apPos[k], staPos);
+        const StaFlowStats &flows = g_flows.monitor ? g_flows.interval[i] : noFlowStats;
+        PhyCounters staPhy = g_sta.phyStats[i];
+        g_sta.phyStats[i] = PhyCounters();
+        g_sta.sentDl[i] = dlThroughput;
+        g_sta.sentDistance[i] = distance;
+        staStats.Stop();
+
+        if (partitioned)
+        {
+            PartitionRecord &record = partitionRecords.emplace_back();
+            FillEnvStruct(&record.env,
+                          staPos.x,
+                          staPos.y,
+                          distance,
+                          dlThroughput,
+                          ulThroughput[k],
+                          old_txPower[k],
+                          g_sta.ids[i],
+                          g_ap.ids[k],
+                          nowSeconds,
+                          flows,
+                          staPhy,
+                          apRxDrops[k]);
+            record.setApTx = controllerTxPower[k];
+        }
+        else if (telemetryOnly)
+        {
+            EnvStruct env;
+            FillEnvStruct(&env,
+                          staPos.x,
+                          staPos.y,
+                          distance,
+                          dlThroughput,
+                          ulThroughput[k],
+                          old_txPower[k],
+                          g_sta.ids[i],
+                          g_ap.ids[k],
+                          nowSeconds,
+                          flows,
+                          staPhy,
+                          apRxDrops[k]);
+            g_telemetryLog.Append(env, controllerTxPower[k]);
+        }
+        else if (ringMode)
+        {
+            FillEnvStruct(static_cast<EnvStruct *>(g_ring.Telemetry().Slot(ringStart + i)),
+                          staPos.x,
+                          staPos.y,
+                          distance,
+                          dlThroughput,
+                          ulThroughput[k],
+                          old_txPower[k],
+                          g_sta.ids[i],
+                          g_ap.ids[k],
+                          nowSeconds,
+                          flows,
+                          staPhy,
+                          apRxDrops[k]);
+        }
+        else if (asyncMode)
+        {
+            FillEnvStruct(&asyncRecords.emplace_back(),
+                          staPos.x,
+                          staPos.y,
+                          distance,
+                          dlThroughput,
+                          ulThroughput[k],
+                          old_txPower[k],
+                          g_sta.ids[i],
+                          g_ap.ids[k],
+                          nowSeconds,
+                          flows,
+                          staPhy,
+                          apRxDrops[k]);
+        }
+        else if (batch)
+        {
+            // Append the STA record to the batch; Python answers once per report
+            FillEnvStruct(&batch->env_records[batch->env_count++],
+                          staPos.x,
+                          staPos.y,
+                          distance,
+                          dlThroughput,
+                          ulThroughput[k],
+                          old_txPower[k],
+                          g_sta.ids[i],
+                          g_ap.ids[k],
+                          nowSeconds,
+                          flows,
+                          staPhy,
+                          apRxDrops[k]);
+        }
+        else if (compact)
+        {
+            // Only the per-STA fields; the header and aps carry the rest
+            FillCompactStaRecord(&compact->stas[compact->header.sta_count++],
+                                 staPos,
+                                 dlThroughput,
+                                 g_sta.ids[i],
+                                 g_ap.ids[k],
+                                 flows,
+                                 staPhy);
+        }
+        else if (envVector)
+        {
+            // Write the STA record into this report's slice of the shared vector
+            FillEnvStruct(&envVector->at(g_vectorReports * g_config.nStas + i),
+                          staPos.x,
+                          staPos.y,
+                          distance,
+                          dlThroughput,
+                          ulThroughput[k],
+                          old_txPower[k],
+                          g_sta.ids[i],
+                          g_ap.ids[k],
+                          nowSeconds,
+                          flows,
+                          staPhy,
+                          apRxDrops[k]);
+        }
+        else
+        {
+            // Interact with AI (Python) for new AP Tx power
+            ApplyAction(LetsTalk(msgInterface,
+                                 staPos.x,
+                                 staPos.y,
+                                 distance,
+                                 dlThroughput,
+                                 ulThroughput[k],
+                                 old_txPower[k],
+                                 g_sta.ids[i],
+                                 g_ap.ids[k],
+                                 nowSeconds,
+                                 flows,
+                                 staPhy,
+                                 apRxDrops[k],
+                                 &g_profiler),
+                        new_txPower);
+            NS_LOG_DEBUG("C++;GetReport: Python Response TX: " << new_txPower[k]);
+        }
+
+        // Display station performance metrics
+        NS_LOG_INFO("[Station " << i << "] AP: " << k << " IP: " << g_sta.ips[i]
+                                << " Position: (" << staPos.x << ", " << staPos.y
+                                << "), Distance: " << distance << "m, DL: " << dlThroughput
+                                << "Mbps, UL: " << ulThroughput[k] << "Mbps");
+    }
+
+    if (partitioned)
+    {
+        ExchangePartitionReport(partitionRecords, new_txPower, nowSeconds);
+    }
+    else if (batch)
+    {
+        ApplyAction(EndBatchReport(batchMsgInterface, &g_profiler), new_txPower);
+        NS_LOG_DEBUG("C++;GetReport: Python Response TX: " << new_txPower[0]);
+    }
+    else if (compact)
+    {
+        ApplyAction(EndBatchReport(compactMsgInterface, &g_profiler), new_txPower);
+        NS_LOG_DEBUG("C++;GetReport: Python Response TX: " << new_txPower[0]);
+    }
+    else if (telemetryOnly)
+    {
+        // One columnar block per report
+        g_telemetryLog.Flush();
+    }
+    else if (ringMode)
+    {
+        // Publish without waiting for a reply, then apply the newest action that has arrived
+        if (std::optional<ActBatchStruct> action = EndRingReport(&g_profiler))
+        {
+            ApplyAction(*action, new_txPower);
+            NS_LOG_DEBUG("C++;GetReport: Python Response TX: " << new_txPower[0]);
+        }
+    }
+    else if (asyncMode)
+    {
+        // Publish without waiting, then apply a sufficiently old reply if one has arrived
+        PublishAsyncReport(g_reportSeq, std::move(asyncRecords));
+        if (std::optional<ActBatchStruct> action = TakeAsyncAction(g_reportSeq))
+        {
+            ApplyAction(*action, new_txPower);
+            NS_LOG_DEBUG("C++;GetReport: Python Response TX: " << new_txPower[0]);
+        }
+    }
+    else if (envVector)
+    {
+        // Exchange once the window is full (or the simulation ends); keep Tx power otherwise
+        if (++g_vectorReports == g_queueDepth || lastReport)
+        {
+            ApplyAction(EndVectorReport(msgInterface, &g_profiler), new_txPower);
+            NS_LOG_DEBUG("C++;GetReport: Python Response TX: " << new_txPower[0]);
+        }
+    }
+
+    // Native controllers override any Python reply and learn from their BSS in this report
+    ProfileScope txUpdate(&g_profiler, PROFILE_TX_UPDATE);
+    for (uint32_t k = 0; k < g_txControllers.size(); ++k)
+    {
+        new_txPower[k] = controllerTxPower[k];
+        g_txControllers[k]->Observe({nowSeconds,
+                                     old_txPower[k],
+                                     bssStas[k] == 0 ? 0.0 : dlSum[k] / bssStas[k],
+                                     ulThroughput[k],
+                                     bssStas[k]});
+    }
+
+    // Set the new Tx power of every AP (only once per report)
+    for (uint32_t k = 0; k < nAps; ++k)
+    {
+        g_ap.phys[k]->SetTxPowerStart(new_txPower[k]);
+        g_ap.phys[k]->SetTxPowerEnd(new_txPower[k]);
+    }
+    txUpdate.Stop();
+
+    // Production summary: one line per report (partitioned runs: by the coordinator)
+    if (g_verbosity >= 1 && !partitioned)
+    {
+        double dlTotal = std::accumulate(dlSum.begin(), dlSum.end(), 0.0);
+        double ulTotal = std::accumulate(ulThroughput.begin(), ulThroughput.end(), 0.0);
+        std::cout << "Report @ " << nowSeconds << "s: " << nStas << " STAs, mean DL "
+                  << (nStas == 0 ? 0.0 : dlTotal / nStas) << "Mbps, UL " << ulTotal << "Mbps";
+        if (nAps == 1)
+        {
+            std::cout << ", AP Tx " << old_txPower[0] << " -> " << new_txPower[0] << "dBm\n";
+        }
+        else
+        {
+            std::cout << ", " << nAps << " APs, mean AP Tx "
+                      << std::accumulate(old_txPower.begin(), old_txPower.end(), 0.0) / nAps
+                      << " -> "
+                      << std::accumulate(new_txPower.begin(), new_txPower.end(), 0.0) / nAps
+                      << "dBm\n";
+        }
+    }
+
+    g_ap.sentUl = ulThroughput;
+    g_lastSentReport = nowSeconds;
+    ++g_reportSeq;
+    g_profiler.EndReport();
+
+    // Schedule the next report if simulation time not exceeded (a sent report ends stretching)
+    if (!lastReport)
+    {
+        Time next = Seconds(g_config.interval);
+        Simulator::Schedule(next, &GetReport, next);
+    }
+}
+
+// Returns the position of AP k in a grid or hex layout of nAps APs centred on the origin
+Vector ApPosition(uint32_t k, uint32_t nAps, const std::string &topology, double spacing)
+{
+    uint32_t cols = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(nAps))));
+    uint32_t rows = (nAps + cols - 1) / cols;
+    uint32_t row = k / cols;
+    uint32_t col = k % cols;
+    if (topology == "hex")
+    {
+        // Odd rows shifted by half a spacing, rows sqrt(3)/2 spacing apart
+        double pitch = spacing * std::sqrt(3.0) / 2.0;
+        double shift = (row % 2 ? 0.5 : 0.0) - (rows > 1 ? 0.25 : 0.0);
+        return Vector((col - (cols - 1) / 2.0 + shift) * spacing,
+                      (row - (rows - 1) / 2.0) * pitch,
+                      0.0);
+    }
+    return Vector((col - (cols - 1) / 2.0) * spacing, (row - (rows - 1) / 2.0) * spacing, 0.0);
+}
+
+// Returns the index of the first STA of BSS k (STAs are split into nAps contiguous blocks)
+uint32_t BssFirstSta(uint32_t k)
+{
+    return static_cast<uint64_t>(k) * g_config.nStas / g_config.nAps;
+}
+
+/*
+ * Installs one traffic source of the configured trafficModel on a node:
+ * - cbr: UdpClient, one packetSize packet every clientInterval
+ * - poisson: PoissonUdpClient, same mean load with exponential gaps
+ * - saturated: always-on OnOffApplication at onOffRate
+ */
+ApplicationContainer InstallTrafficSource(Ptr<Node> node, Ipv4Address destination, uint16_t port)
+{
+    if (g_config.trafficModel == "poisson")
+    {
+        Ptr<PoissonUdpClient> client = CreateObject<PoissonUdpClient>();
+        client->SetAttribute("RemoteAddress", AddressValue(InetSocketAddress(destination, port)));
+        client->SetAttribute("PacketSize", UintegerValue(g_config.packetSize));
+        client->SetAttribute("MeanInterval", TimeValue(Seconds(g_config.clientInterval)));
+        node->AddApplication(client);
+        return ApplicationContainer(client);
+    }
+    if (g_config.trafficModel == "saturated")
+    {
+        OnOffHelper onOff("ns3::UdpSocketFactory", InetSocketAddress(destination, port));
+        onOff.SetConstantRate(DataRate(g_config.onOffRate), g_config.packetSize);
+        return onOff.Install(node);
+    }
+    UdpClientHelper client(destination, port);
+    client.SetAttribute("MaxPackets", UintegerValue(4294967295U));
+    client.SetAttribute("Interval", TimeValue(Seconds(g_config.clientInterval)));
+    client.SetAttribute("PacketSize", UintegerValue(g_config.packetSize));
+    return client.Install(node);
+}
+
+// EtherType of the lean scenario's packet-socket traffic (IEEE 802 local experimental)
+constexpr uint16_t LEAN_PROTOCOL = 0x88B5;
+
+/*
+ * Lean scenario: installs one MultiPeerSource per node with the per-flow load
+ * of the trafficModel (saturated: one packet per packetSize at onOffRate)
+ * and a socket of g_leanSink on every node instead of a PacketSink:
+ * - AP a sends to all STAs of its BSS, each STA to its AP
+ * - UDP to the sink port, or raw frames to the peer's MAC (packetSockets)
+ */
+void InstallLeanTraffic(const std::vector<uint32_t> &firstSta,
+                        const Ipv4InterfaceContainer &apIf,
+                        const Ipv4InterfaceContainer &staIf,
+                        uint16_t port)
+{
+    TypeId factory = g_config.packetSockets ? PacketSocketFactory::GetTypeId()
+                                            : UdpSocketFactory::GetTypeId();
+    double flowInterval = g_config.clientInterval;
+    if (g_config.trafficModel == "saturated")
+    {
+        flowInterval = g_config.packetSize * 8.0 / DataRate(g_config.onOffRate).GetBitRate();
+    }
+
+    // Packet-socket address of lean frames on device, sent to (or received at) a MAC address
+    auto frameAddress = [](Ptr<NetDevice> device, const Address &mac) -> Address {
+        PacketSocketAddress address;
+        address.SetSingleDevice(device->GetIfIndex());
+        address.SetPhysicalAddress(mac);
+        address.SetProtocol(LEAN_PROTOCOL);
+        return address;
+    };
+    // Sink address on a node's device: the UDP port, or the device and the lean EtherType
+    auto sinkAddress = [&](Ptr<NetDevice> device) -> Address {
+        return g_config.packetSockets ? frameAddress(device, device->GetAddress())
+                                      : Address(InetSocketAddress(Ipv4Address::GetAny(), port));
+    };
+    // Destination of a flow from device to peer (IPv4 address ip with the IP stack)
+    auto peerAddress = [&](Ptr<NetDevice> device, Ptr<NetDevice> peer, Ipv4Address ip) -> Address {
+        return g_config.packetSockets ? frameAddress(device, peer->GetAddress())
+                                      : Address(InetSocketAddress(ip, port));
+    };
+    auto source = [&](Ptr<Node> node) {
+        Ptr<MultiPeerSource> app = CreateObject<MultiPeerSource>();
+        app->SetAttribute("SocketFactory", TypeIdValue(factory));
+        app->SetAttribute("PacketSize", UintegerValue(g_config.packetSize));
+        app->SetAttribute("Interval", TimeValue(Seconds(flowInterval)));
+        app->SetAttribute("Poisson", BooleanValue(g_config.trafficModel == "poisson"));
+        app->SetStartTime(Seconds(TrafficStartTime()));
+        app->SetStopTime(Seconds(g_config.totalTime));
+        node->AddApplication(app);
+        return app;
+    };
+
+    // Sink slots: STA i is slot i, AP a is slot nStas + a (see StaRxBytes and ApRxBytes)
+    g_leanSink = CreateObject<SharedByteSink>();
+    for (uint32_t i = 0; i < wifiStaNodes.GetN(); ++i)
+    {
+        g_leanSink->Listen(wifiStaNodes.Get(i), factory, sinkAddress(staDevices.Get(i)));
+    }
+    for (uint32_t a = 0; a < wifiApNodes.GetN(); ++a)
+    {
+        g_leanSink->Listen(wifiApNodes.Get(a), factory, sinkAddress(apDevices.Get(a)));
+    }
+
+    bool ip = !g_config.packetSockets;
+    for (uint32_t a = 0; a < wifiApNodes.GetN(); ++a)
+    {
+        Ptr<MultiPeerSource> downlink = source(wifiApNodes.Get(a));
+        for (uint32_t i = firstSta[a]; i < firstSta[a + 1]; ++i)
+        {
+            downlink->AddPeer(peerAddress(apDevices.Get(a),
+                                          staDevices.Get(i),
+                                          ip ? staIf.GetAddress(i) : Ipv4Address()));
+            source(wifiStaNodes.Get(i))
+                ->AddPeer(peerAddress(staDevices.Get(i),
+                                      apDevices.Get(a),
+                                      ip ? apIf.GetAddress(a) : Ipv4Address()));
+        }
+    }
+}
+
+/*
+ * Builds the scenario's loss chain, shared by the exact and cached channels and
+ * the channel trace sampler: the default LogDistance stage of
+ * YansWifiChannelHelper::Default(), the configured LogDistance stage, then
+ * Nakagami fading.
+ * @param fading Set to the fading stage
+ * @param chainFading Append the fading stage to the chain (false: the caller applies it)
+ * @return First stage of the chain
+ */
+Ptr<PropagationLossModel>
+CreateLossChain(Ptr<NakagamiPropagationLossModel> &fading, bool chainFading)
+{
+    Ptr<LogDistancePropagationLossModel> defaultLoss =
+        CreateObject<LogDistancePropagationLossModel>();
+    Ptr<LogDistancePropagationLossModel> scenarioLoss =
+        CreateObject<LogDistancePropagationLossModel>();
+    scenarioLoss->SetAttribute("Exponent", DoubleValue(g_config.lossExponent));
+    scenarioLoss->SetAttribute("ReferenceLoss", DoubleValue(40.0459));
+    defaultLoss->SetNext(scenarioLoss);
+    fading = CreateObject<NakagamiPropagationLossModel>();
+    fading->SetAttribute("m0", DoubleValue(1.0));
+    fading->SetAttribute("m1", DoubleValue(1.0));
+    fading->SetAttribute("m2", DoubleValue(1.0));
+    if (chainFading)
+    {
+        scenarioLoss->SetNext(fading);
+    }
+    return defaultLoss;
+}
+
+// Appends one sample of every node position and link gain to the channel trace
+void SampleChannel()
+{
+    uint32_t n = g_trace.mobility.size();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        Vector position = g_trace.mobility[i]->GetPosition();
+        g_trace.positions[2 * i] = position.x;
+        g_trace.positions[2 * i + 1] = position.y;
+    }
+    uint64_t pair = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        for (uint32_t j = i + 1; j < n; ++j)
+        {
+            g_trace.gains[pair++] =
+                g_trace.sampler->CalcRxPower(0.0, g_trace.mobility[i], g_trace.mobility[j]);
+        }
+    }
+    NS_ABORT_MSG_IF(!g_trace.writer.Append(g_trace.positions, g_trace.gains),
+                    "Cannot write channel trace " << g_traceRecord);
+}
+
+// Appends every sample due by time t (s), sample s being due at s x step
+void SampleChannelUntil(double t)
+{
+    while (g_trace.writer.GetSampleCount() * g_trace.step <= t + 1e-9)
+    {
+        SampleChannel();
+    }
+}
+
+// Brings the recording's sampled gains up to now, before a frame uses them
+void UpdateChannelTrace()
+{
+    SampleChannelUntil(Simulator::Now().GetSeconds());
+}
+
+// Samples the channel now and every step up to totalTime, including steps without frames (the
+// sample at totalTime is taken after Simulator::Run, which stops before events of its stop time)
+void RecordChannelTrace(Time step)
+{
+    UpdateChannelTrace();
+    if (Simulator::Now() + step < Seconds(g_config.totalTime))
+    {
+        Simulator::Schedule(step, &RecordChannelTrace, step);
+    }
+}
+
+/*
+ * Opens the channel trace of traceRecord and schedules its samples. Link gains
+ * are drawn from a separate instance of the scenario's loss chain (see
+ * CreateLossChain()), once per pair and sample, and the recording's PHYs see
+ * them through g_trace.channel, so the recording run gets the channel of its
+ * replays.
+ */
+void StartChannelTrace()
+{
+    NodeContainer nodes(wifiApNodes, wifiStaNodes);
+    g_trace.step = g_traceStep > 0.0 ? g_traceStep : g_config.interval;
+    NS_ABORT_MSG_IF(
+        !g_trace.writer.Open(g_traceRecord, nodes.GetN(), wifiApNodes.GetN(), g_trace.step),
+        "Cannot open channel trace " << g_traceRecord);
+    g_trace.mobility.clear();
+    for (uint32_t n = 0; n < nodes.GetN(); ++n)
+    {
+        g_trace.mobility.push_back(nodes.Get(n)->GetObject<MobilityModel>());
+        g_trace.channel->AddNode(g_trace.mobility.back(), n);
+    }
+    g_trace.positions.assign(2 * nodes.GetN(), 0.0f);
+    g_trace.gains.assign(TracePairCount(nodes.GetN()), 0.0f);
+    g_trace.channel->SetSample(&g_trace.gains, MakeCallback(&UpdateChannelTrace));
+
+    Ptr<NakagamiPropagationLossModel> fading;
+    g_trace.sampler = CreateLossChain(fading, true);
+    if (g_config.warmStart)
+    {
+        // Pinned like the devices and mobility, so recordings repeat across policies
+        fading->AssignStreams(TRACE_FADING_STREAM);
+    }
+
+    Simulator::ScheduleNow(&RecordChannelTrace, Seconds(g_trace.step));
+}
+
+// Returns the resident memory of this process (bytes, 0 without /proc)
+uint64_t ResidentBytes()
+{
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    statm >> size >> resident;
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+// Sets up the WiFi scenario: nodes, devices, mobility, IP, UDP apps
+void InitializeScenario()
+{
+    using namespace ns3::energy;
+    NS_LOG_INFO("C++;InitializeScenario: Initializing the scenario.");
+
+    // Create AP and STA nodes: the APs of this process (all without partitions) and their STAs;
+    // firstSta[a] is the local index of the first STA of local AP a
+    NS_LOG_INFO("C++;InitializeScenario: Creating AP and STA nodes.");
+    uint32_t nLocalAps = g_localAps.size();
+    std::vector<uint32_t> firstSta(nLocalAps + 1, 0);
+    for (uint32_t a = 0; a < nLocalAps; ++a)
+    {
+        uint32_t k = g_localAps[a];
+        firstSta[a + 1] = firstSta[a] + BssFirstSta(k + 1) - BssFirstSta(k);
+    }
+    wifiApNodes.Create(nLocalAps);
+    wifiStaNodes.Create(firstSta[nLocalAps]);
+
+    // Set up WiFi channel and PHY layer with 1 antenna and 1 spatial stream
+    NS_LOG_INFO("C++;InitializeScenario: Setting up WiFi channel and PHY layer.");
+    YansWifiPhyHelper phy;
+    if (!g_traceReplay.empty())
+    {
+        // Replay: recorded gain of every link, no loss model evaluations
+        Ptr<TraceLossModel> traceLoss = CreateObject<TraceLossModel>();
+        traceLoss->SetTrace(&g_trace.reader);
+        Ptr<YansWifiChannel> yansChannel = CreateObject<YansWifiChannel>();
+        yansChannel->SetPropagationLossModel(traceLoss);
+        yansChannel->SetPropagationDelayModel(
+            CreateObject<ConstantSpeedPropagationDelayModel>());
+        phy.SetChannel(yansChannel);
+    }
+    else if (!g_traceRecord.empty())
+    {
+        // Recording: the gains of the sample being written (StartChannelTrace() registers nodes)
+        g_trace.channel = CreateObject<SampledLossModel>();
+        Ptr<YansWifiChannel> yansChannel = CreateObject<YansWifiChannel>();
+        yansChannel->SetPropagationLossModel(g_trace.channel);
+        yansChannel->SetPropagationDelayModel(
+            CreateObject<ConstantSpeedPropagationDelayModel>());
+        phy.SetChannel(yansChannel);
+    }
+    else if (g_config.lossModel == "cached")
+    {
+        // The scenario's chain with Nakagami fading applied on the cached mean power
+        Ptr<NakagamiPropagationLossModel> fading;
+        Ptr<PropagationLossModel> deterministic = CreateLossChain(fading, false);
+
+        g_cachedLoss = CreateObject<CachedPairLossModel>();
+        g_cachedLoss->SetAttribute("DeterministicModel", PointerValue(deterministic));
+        g_cachedLoss->SetAttribute("FadingModel", PointerValue(fading));
+        g_cachedLoss->SetAttribute("DistanceThreshold", DoubleValue(g_config.lossCacheThreshold));
+        g_cachedLoss->SetAttribute("MaxSpeed", DoubleValue(g_config.staSpeed));
+        g_cachedLoss->SetAttribute("PruneRange", DoubleValue(g_config.pruneRange));
+        g_cachedLoss->SetAttribute("PruneRxPower", DoubleValue(g_config.pruneRxPower));
+
+        Ptr<YansWifiChannel> yansChannel = CreateObject<YansWifiChannel>();
+        yansChannel->SetPropagationLossModel(g_cachedLoss);
+        yansChannel->SetPropagationDelayModel(
+            CreateObject<ConstantSpeedPropagationDelayModel>());
+        phy.SetChannel(yansChannel);
+    }
+    else
+    {
+        // The whole chain, as YansWifiChannelHelper::Default() plus both added stages builds it
+        Ptr<NakagamiPropagationLossModel> fading;
+        Ptr<YansWifiChannel> yansChannel = CreateObject<YansWifiChannel>();
+        yansChannel->SetPropagationLossModel(CreateLossChain(fading, true));
+        yansChannel->SetPropagationDelayModel(
+            CreateObject<ConstantSpeedPropagationDelayModel>());
+        phy.SetChannel(yansChannel);
+    }
+    phy.Set("Antennas", UintegerValue(1));
+    phy.Set("MaxSupportedTxSpatialStreams", UintegerValue(1));
+    phy.Set("MaxSupportedRxSpatialStreams", UintegerValue(1));
+
+    // Configure MAC and WiFi standard (802.11n), and set rate control
+    NS_LOG_INFO("C++;InitializeScenario: Configuring MAC and WiFi standard.");
+    WifiMacHelper mac;
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211n);
+    if (g_config.rateManager == "minstrel")
+    {
+        wifi.SetRemoteStationManager("ns3::MinstrelHtWifiManager");
+    }
+    else if (g_config.rateManager == "ideal")
+    {
+        wifi.SetRemoteStationManager("ns3::IdealWifiManager");
+    }
+    else
+    {
+        // action: constant rate until Python sets per-STA MCS (see ApplyStaActions)
+        wifi.SetRemoteStationManager(g_config.rateManager == "action"
+                                         ? "ns3::ActionRateWifiManager"
+                                         : "ns3::ConstantRateWifiManager",
+                                     "DataMode",
+                                     StringValue(g_config.dataMode),
+                                     "ControlMode",
+                                     StringValue(g_config.controlMode));
+    }
+
+    // One BSS per AP, all on the shared channel; BSS k serves a contiguous block of STAs
+    std::vector<Ssid> ssids;
+    ssids.reserve(nLocalAps);
+    for (uint32_t a = 0; a < nLocalAps; ++a)
+    {
+        uint32_t k = g_localAps[a];
+        Ssid ssid = g_config.nAps == 1 ? Ssid("ns3-80211n-mimo")
+                                       : Ssid("ns3-80211n-mimo-" + std::to_string(k));
+        ssids.push_back(ssid);
+        NodeContainer bssStaNodes;
+        for (uint32_t i = firstSta[a]; i < firstSta[a + 1]; ++i)
+        {
+            bssStaNodes.Add(wifiStaNodes.Get(i));
+        }
+
+        // Install STA devices with the BSS SSID; active probing only for a warm start
+        // (a probe response arrives in milliseconds instead of waiting for a beacon)
+        mac.SetType("ns3::StaWifiMac",
+                    "Ssid",
+                    SsidValue(ssid),
+                    "ActiveProbing",
+                    BooleanValue(g_config.warmStart),
+                    "BE_MaxAmpduSize",
+                    UintegerValue(g_config.maxAmpduSize));
+        staDevices.Add(wifi.Install(phy, mac, bssStaNodes));
+        // when you do something difficult, the labour passes quickly but the pride endures
+        // when you do something shameful for pleasure, the pleasure passes quickly but the shame
+        // endures
+
+        // Install AP device with the BSS SSID
+        mac.SetType("ns3::ApWifiMac",
+                    "Ssid",
+                    SsidValue(ssid),
+                    "BE_MaxAmpduSize",
+                    UintegerValue(g_config.maxAmpduSize));
+        apDevices.Add(wifi.Install(phy, mac, wifiApNodes.Get(a)));
+    }
+
+    // Set up mobility for APs: fixed positions on the grid/hex layout
+    NS_LOG_INFO("C++;InitializeScenario: Setting up mobility for AP and STAs.");
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    std::vector<Vector> apPositions;
+    apPositions.reserve(nLocalAps);
+    for (uint32_t k : g_localAps)
+    {
+        apPositions.push_back(
+            ApPosition(k, g_config.nAps, g_config.apTopology, g_config.apSpacing));
+        positionAlloc->Add(apPositions.back());
+    }
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positionAlloc);
+    bool replay = !g_traceReplay.empty();
+    if (!replay)
+    {
+        mobility.Install(wifiApNodes);
+    }
+
+    // Set up mobility for STAs: start on a circle around their AP, then a slow random walk
+    // within the area of their partition (the whole AP layout without partitions): the
+    // bounding box of its APs extended by mobilityBound, so STAs never walk into the area
+    // of a partition that another process simulates
+    MobilityHelper staMobility;
+    if (!replay)
+    {
+        std::vector<Vector> allApPositions;
+        std::vector<std::vector<uint32_t>> partitionAps(1);
+        for (uint32_t k = 0; k < g_config.nAps; ++k)
+        {
+            allApPositions.push_back(
+                ApPosition(k, g_config.nAps, g_config.apTopology, g_config.apSpacing));
+            uint32_t p = g_apPartition.empty() ? 0 : g_apPartition[k];
+            partitionAps.resize(std::max<std::size_t>(partitionAps.size(), p + 1));
+            partitionAps[p].push_back(k);
+        }
+        for (uint32_t a = 0; a < nLocalAps; ++a)
+        {
+            uint32_t k = g_localAps[a];
+            PartitionArea area =
+                ApGroupArea(allApPositions,
+                            partitionAps[g_apPartition.empty() ? 0 : g_apPartition[k]],
+                            g_config.mobilityBound);
+            const Vector &center = apPositions[a];
+            Ptr<ListPositionAllocator> staPositionAlloc = CreateObject<ListPositionAllocator>();
+            NodeContainer bssStaNodes;
+            uint32_t count = firstSta[a + 1] - firstSta[a];
+            for (uint32_t j = 0; j < count; ++j)
+            {
+                double angle = (2 * M_PI * j) / count;
+                double x = center.x + g_config.initDistance * cos(angle);
+                double y = center.y + g_config.initDistance * sin(angle);
+                staPositionAlloc->Add(Vector(x, y, 0.0));
+                bssStaNodes.Add(wifiStaNodes.Get(firstSta[a] + j));
+            }
+            staMobility.SetPositionAllocator(staPositionAlloc);
+            staMobility.SetMobilityModel(
+                "ns3::RandomWalk2dMobilityModel",
+                "Bounds",
+                RectangleValue(Rectangle(area.minX, area.maxX, area.minY, area.maxY)),
+                "Speed",
+                StringValue("ns3::ConstantRandomVariable[Constant=" +
+                            std::to_string(g_config.staSpeed) + "]"));
+            staMobility.Install(bssStaNodes);
+        }
+    }
+    else
+    {
+        // Replay: every node follows its recorded positions (APs, then STAs, as recorded)
+        NodeContainer nodes(wifiApNodes, wifiStaNodes);
+        for (uint32_t n = 0; n < nodes.GetN(); ++n)
+        {
+            Ptr<TraceMobilityModel> model = CreateObject<TraceMobilityModel>();
+            model->SetTrace(&g_trace.reader, n);
+            nodes.Get(n)->AggregateObject(model);
+        }
+    }
+
+    // Install Internet stack (TCP/IP) on all nodes, or only packet sockets (lean, no IP)
+    bool ipStack = !g_config.packetSockets;
+    Ipv4InterfaceContainer apIf;
+    Ipv4InterfaceContainer staIf;
+    if (ipStack)
+    {
+        NS_LOG_INFO("C++;InitializeScenario: Installing Internet stack on nodes.");
+        InternetStackHelper stack;
+        stack.Install(wifiApNodes);
+        stack.Install(wifiStaNodes);
+
+        // Assign IP addresses to AP and STA devices (one flat subnet, /16 beyond 254 nodes)
+        Ipv4AddressHelper address;
+        if (wifiApNodes.GetN() + wifiStaNodes.GetN() < 255)
+        {
+            address.SetBase("192.168.1.0", "255.255.255.0");
+        }
+        else
+        {
+            address.SetBase("10.1.0.0", "255.255.0.0");
+        }
+        apIf = address.Assign(apDevices);
+        staIf = address.Assign(staDevices);
+    }
+    else
+    {
+        NS_LOG_INFO("C++;InitializeScenario: Installing packet sockets on nodes.");
+        PacketSocketHelper packetSocket;
+        packetSocket.Install(wifiApNodes);
+        packetSocket.Install(wifiStaNodes);
+    }
+
+    g_apIf = apIf;
+    g_staIf = staIf;
+
+    // Warm start: fill every ARP cache up front so the first packets need no ARP
+    // exchange, and fix the RNG streams of the devices and STA mobility so runs
+    // that only differ in the control policy see the same channel and movement
+    if (g_config.warmStart)
+    {
+        if (ipStack)
+        {
+            NeighborCacheHelper neighborCache;
+            neighborCache.PopulateNeighborCache();
+        }
+        int64_t stream = 1000;
+        stream += wifi.AssignStreams(apDevices, stream);
+        stream += wifi.AssignStreams(staDevices, stream);
+        staMobility.AssignStreams(wifiStaNodes, stream);
+    }
+
+    // Set up UDP sinks on each STA and AP, and track received bytes
+    uint16_t port = 9;
+    ApplicationContainer staSinkApps;
+    ApplicationContainer apSinkApps;
+    if (g_config.lean)
+    {
+        NS_LOG_INFO("C++;InitializeScenario: Setting up the shared sink and lean sources.");
+        InstallLeanTraffic(firstSta, apIf, staIf, port);
+    }
+    else
+    {
+        NS_LOG_INFO("C++;InitializeScenario: Setting up UDP sinks on STAs and AP.");
+        PacketSinkHelper sink("ns3::UdpSocketFactory",
+                              InetSocketAddress(Ipv4Address::GetAny(), port));
+        staSinkApps = sink.Install(wifiStaNodes);
+        staSinkApps.Start(Seconds(0.0));
+        staSinkApps.Stop(Seconds(g_config.totalTime));
+        apSinkApps = sink.Install(wifiApNodes);
+        apSinkApps.Start(Seconds(0.0));
+        apSinkApps.Stop(Seconds(g_config.totalTime));
+
+        // Set up traffic sources for both downlink (AP→STA) and uplink (STA→AP) within each BSS
+        ApplicationContainer apToStaApps;
+        ApplicationContainer staToApApps;
+
+        for (uint32_t a = 0; a < nLocalAps; ++a)
+        {
+            for (uint32_t i = firstSta[a]; i < firstSta[a + 1]; ++i)
+            {
+                // Downlink: AP[a] sends to STA[i]
+                apToStaApps.Add(
+                    InstallTrafficSource(wifiApNodes.Get(a), staIf.GetAddress(i), port));
+
+                // Uplink: STA[i] sends to AP[a]
+                staToApApps.Add(
+                    InstallTrafficSource(wifiStaNodes.Get(i), apIf.GetAddress(a), port));
+            }
+        }
+        // Start and stop traffic sources at the correct times
+        apToStaApps.Start(Seconds(TrafficStartTime()));
+        apToStaApps.Stop(Seconds(g_config.totalTime));
+        staToApApps.Start(Seconds(TrafficStartTime()));
+        staToApApps.Stop(Seconds(g_config.totalTime));
+    }
+
+    // Build the per-AP and per-STA state tables used by every report (local indices, global ids)
+    g_ap = ApStateTable();
+    g_ap.Reserve(nLocalAps);
+    g_sta = StaStateTable();
+    g_sta.Reserve(firstSta[nLocalAps]);
+    for (uint32_t a = 0; a < nLocalAps; ++a)
+    {
+        uint32_t k = g_localAps[a];
+        Ptr<WifiNetDevice> apDev = DynamicCast<WifiNetDevice>(apDevices.Get(a));
+        g_ap.Add(g_config.lean ? Ptr<PacketSink>() : DynamicCast<PacketSink>(apSinkApps.Get(a)),
+                 wifiApNodes.Get(a)->GetObject<MobilityModel>(),
+                 DynamicCast<YansWifiPhy>(apDev->GetPhy()),
+                 ssids[a],
+                 DynamicCast<ActionRateWifiManager>(apDev->GetRemoteStationManager()),
+                 k);
+        for (uint32_t i = firstSta[a]; i < firstSta[a + 1]; ++i)
+        {
+            Ptr<WifiNetDevice> staDev = DynamicCast<WifiNetDevice>(staDevices.Get(i));
+            g_sta.Add(g_config.lean ? Ptr<PacketSink>()
+                                    : DynamicCast<PacketSink>(staSinkApps.Get(i)),
+                      wifiStaNodes.Get(i)->GetObject<MobilityModel>(),
+                      DynamicCast<YansWifiPhy>(staDev->GetPhy()),
+                      ipStack ? staIf.GetAddress(i) : Ipv4Address(),
+                      Mac48Address::ConvertFrom(staDev->GetAddress()),
+                      a,
+                      DynamicCast<ActionRateWifiManager>(staDev->GetRemoteStationManager()),
+                      BssFirstSta(k) + (i - firstSta[a]));
+        }
+    }
+
+    // PHY trace sinks, bound to the (now complete) state tables
+    for (uint32_t k = 0; k < g_ap.Size(); ++k)
+    {
+        ConnectPhyTraces(g_ap.phys[k], &g_ap.phyStats[k]);
+    }
+    for (uint32_t i = 0; i < g_sta.Size(); ++i)
+    {
+        ConnectPhyTraces(g_sta.phys[i], &g_sta.phyStats[i]);
+    }
+
+    // Association sinks, bound to the STA index
+    g_staAssociated.assign(g_sta.Size(), false);
+    g_associatedStas = 0;
+    for (uint32_t i = 0; i < g_sta.Size(); ++i)
+    {
+        Ptr<WifiNetDevice> staDev = DynamicCast<WifiNetDevice>(staDevices.Get(i));
+        staDev->GetMac()->TraceConnectWithoutContext("Assoc", MakeBoundCallback(&StaAssocSink, i));
+    }
+
+    // FlowMonitor on every node; flows are matched to STAs by IPv4 address
+    if (g_flowStats)
+    {
+        NS_LOG_INFO("C++;InitializeScenario: Installing FlowMonitor.");
+        g_flows.monitor = g_flows.helper.Install(wifiApNodes);
+        g_flows.helper.Install(wifiStaNodes);
+        g_flows.classifier = DynamicCast<Ipv4FlowClassifier>(g_flows.helper.GetClassifier());
+        for (uint32_t i = 0; i < g_sta.Size(); ++i)
+        {
+            g_flows.staByIp[g_sta.ips[i].Get()] = i;
+        }
+    }
+
+    NS_LOG_INFO("C++;InitializeScenario: Scenario initialized successfully.");
+}
+
+// Returns the resident memory InitializeScenario() added per node of this process (bytes)
+uint64_t ScenarioBytesPerNode()
+{
+    return g_scenarioBytes / (wifiApNodes.GetN() + wifiStaNodes.GetN());
+}
+
+// Appends the metrics of the finished run to g_benchmarkFile as one JSON line
+void WriteBenchmarkRecord(double wallSeconds)
+{
+    std::ofstream out(g_benchmarkFile, std::ios::app);
+    NS_ABORT_MSG_IF(!out, "Cannot open benchmark file " << g_benchmarkFile);
+
+    // Async mode: the round trips run on the IPC worker, the simulation never waits for them
+    const ReportProfiler &ipc = g_ipcMode == "async" ? g_async.profiler : g_profiler;
+    double simSeconds = Simulator::Now().GetSeconds();
+    uint64_t events = Simulator::GetEventCount();
+    struct rusage usage{};
+    getrusage(RUSAGE_SELF, &usage); // ru_maxrss is in KiB on Linux
+
+    out << std::setprecision(9) << "{\"nStas\": " << g_config.nStas
+        << ", \"nAps\": " << g_config.nAps << ", \"interval\": " << g_config.interval
+        << ", \"totalTime\": " << g_config.totalTime << ", \"ipcMode\": \"" << g_ipcMode
+        << "\", \"trafficModel\": \"" << g_config.trafficModel << "\", \"run\": " << g_config.run
+        << ", \"wall_s\": " << wallSeconds << ", \"sim_s\": " << simSeconds
+        << ", \"events\": " << events
+        << ", \"events_per_s\": " << (wallSeconds > 0.0 ? events / wallSeconds : 0.0)
+        << ", \"sim_s_per_wall_s\": " << (wallSeconds > 0.0 ? simSeconds / wallSeconds : 0.0)
+        << ", \"reports\": " << g_profiler.GetReportCount()
+        << ", \"report_p50_us\": " << g_profiler.Percentile(PROFILE_PHASE_COUNT + 1, 0.50)
+        << ", \"report_p99_us\": " << g_profiler.Percentile(PROFILE_PHASE_COUNT + 1, 0.99)
+        << ", \"ipc_rtt_p50_us\": " << ipc.RoundTripPercentile(0.50)
+        << ", \"ipc_rtt_p95_us\": " << ipc.RoundTripPercentile(0.95)
+        << ", \"ipc_rtt_p99_us\": " << ipc.RoundTripPercentile(0.99)
+        << ", \"async_dropped_reports\": " << g_async.dropped
+        << ", \"scenario_bytes_per_node\": " << ScenarioBytesPerNode()
+        << ", \"sim_peak_rss_kb\": " << usage.ru_maxrss << "}\n";
+}
+
+/*
+ * Assigns the APs to processes: without partitionRange this process simulates
+ * all of them. Otherwise the APs are grouped into independent partitions,
+ * spread round-robin over up to partitionProcs processes, and one worker
+ * process per extra rank is forked here, before any simulation state exists.
+ */
+void StartPartitions()
+{
+    g_localAps.clear();
+    g_apPartition.clear();
+    if (g_partitionRange <= 0.0)
+    {
+        g_localAps.resize(g_config.nAps);
+        std::iota(g_localAps.begin(), g_localAps.end(), 0);
+        return;
+    }
+
+    std::vector<Vector> positions;
+    for (uint32_t k = 0; k < g_config.nAps; ++k)
+    {
+        positions.push_back(ApPosition(k, g_config.nAps, g_config.apTopology, g_config.apSpacing));
+    }
+    std::vector<uint32_t> partition =
+        PartitionAps(positions, g_config.mobilityBound, g_partitionRange);
+    uint32_t partitions = 1 + *std::max_element(partition.begin(), partition.end());
+    g_apPartition = partition;
+    g_ranks = g_partitionProcs == 0 ? partitions : std::min(partitions, g_partitionProcs);
+    if (g_verbosity >= 1)
+    {
+        std::cout << "Partitions: " << partitions << " over " << g_ranks << " processes\n";
+    }
+
+    std::cout.flush(); // Buffered output would be written again by every worker
+    for (uint32_t r = 1; r < g_ranks; ++r)
+    {
+        int fds[2];
+        NS_ABORT_MSG_IF(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0, "socketpair failed");
+        pid_t pid = fork();
+        NS_ABORT_MSG_IF(pid < 0, "fork failed");
+        if (pid == 0)
+        {
+            // Worker r: only the link to the coordinator stays open; no console summaries
+            close(fds[0]);
+            for (PartitionLink &worker : g_workers)
+            {
+                worker.Close();
+            }
+            g_workers.clear();
+            g_workerPids.clear();
+            g_coordinator = PartitionLink(fds[1]);
+            g_rank = r;
+            g_verbosity = 0;
+            g_profile = false;
+            g_benchmarkFile.clear();
+            break;
+        }
+        close(fds[1]);
+        g_workers.emplace_back(fds[0]);
+        g_workerPids.push_back(pid);
+    }
+
+    for (uint32_t k = 0; k < g_config.nAps; ++k)
+    {
+        if (partition[k] % g_ranks == g_rank)
+        {
+            g_localAps.push_back(k);
+        }
+    }
+}
+
+// Registers every ScenarioConfig field as a command-line option
+void AddScenarioOptions(CommandLine &cmd, ScenarioConfig &config)
+{
+    cmd.AddValue("nStas", "Number of STAs", config.nStas);
+    cmd.AddValue("nAps", "Number of APs, one BSS each (STAs are split evenly)", config.nAps);
+    cmd.AddValue("apTopology", "AP layout around the origin: grid or hex", config.apTopology);
+    cmd.AddValue("apSpacing", "Distance between neighbouring APs (m)", config.apSpacing);
+    cmd.AddValue("initDistance",
+                 "Initial distance from its AP to each STA (m)",
+                 config.initDistance);
+    cmd.AddValue("totalTime", "Total simulation time (s)", config.totalTime);
+    cmd.AddValue("warmStart",
+                 "Fast deterministic warm-up: pre-filled ARP caches, active probing, fixed "
+                 "device/mobility RNG streams and an early traffic start",
+                 config.warmStart);
+    cmd.AddValue("trafficStart",
+                 "Start time of the traffic sources (s), negative: interval (0.05 with warmStart)",
+                 config.trafficStart);
+    cmd.AddValue("interval", "Reporting interval (s)", config.interval);
+    cmd.AddValue("reportMode",
+                 "periodic (a report every interval) or change (check every interval, report "
+                 "only when tpDelta, distanceDelta, dropRate or maxSilence triggers)",
+                 config.reportMode);
+    cmd.AddValue("tpDelta",
+                 "Change mode: DL/UL throughput change since the last report that triggers one",
+                 config.tpDelta);
+    cmd.AddValue("distanceDelta",
+                 "Change mode: STA-AP distance change since the last report that triggers one (m)",
+                 config.distanceDelta);
+    cmd.AddValue("dropRate",
+                 "Change mode: fraction of a STA's received frames dropped by the PHY that "
+                 "triggers a report",
+                 config.dropRate);
+    cmd.AddValue("maxSilence",
+                 "Change mode: a report is sent at least this often (s)",
+                 config.maxSilence);
+    cmd.AddValue("maxInterval",
+                 "Change mode: quiet checks are spaced out (doubling) up to this interval "
+                 "(s, 0 or at most interval: fixed checks)",
+                 config.maxInterval);
+    cmd.AddValue("trafficModel",
+                 "Traffic sources: cbr (UdpClient), poisson (exponential gaps, same mean "
+                 "load) or saturated (always-on OnOff at onOffRate)",
+                 config.trafficModel);
+    cmd.AddValue("packetSize",
+                 "UDP payload size of the traffic clients (bytes)",
+                 config.packetSize);
+    cmd.AddValue("clientInterval",
+                 "Time between two packets of a UDP client, mean for poisson traffic (s)",
+                 config.clientInterval);
+    cmd.AddValue("onOffRate",
+                 "Rate of every saturated traffic source (ns-3 DataRate, e.g. 100Mbps)",
+                 config.onOffRate);
+    cmd.AddValue("lean",
+                 "Memory-lean scenario: one multiplexed traffic source per node and one shared "
+                 "byte-counting sink instead of a client per flow and a PacketSink per node",
+                 config.lean);
+    cmd.AddValue("packetSockets",
+                 "Lean scenario: send raw frames over packet sockets instead of UDP (no IP "
+                 "stack; incompatible with flowStats)",
+                 config.packetSockets);
+    cmd.AddValue("maxAmpduSize",
+                 "Best-effort A-MPDU size limit of all MACs (bytes, 0 disables aggregation)",
+                 config.maxAmpduSize);
+    cmd.AddValue("rateManager",
+                 "Rate control of all devices: constant (dataMode), action (dataMode until "
+                 "Python sets per-STA MCS), minstrel (Minstrel-HT) or ideal",
+                 config.rateManager);
+    cmd.AddValue("dataMode",
+                 "Data mode of the constant-rate and action managers",
+                 config.dataMode);
+    cmd.AddValue("controlMode",
+                 "Control mode of the constant-rate and action managers",
+                 config.controlMode);
+    cmd.AddValue("mobilityBound",
+                 "STAs walk up to bound beyond the outermost APs on x and y (m)",
+                 config.mobilityBound);
+    cmd.AddValue("staSpeed", "STA random-walk speed (m/s)", config.staSpeed);
+    cmd.AddValue("lossExponent", "Log-distance propagation loss exponent", config.lossExponent);
+    cmd.AddValue("lossModel",
+                 "exact (full loss chain on every frame) or cached (per node pair path loss, "
+                 "fading only for receivers that are not pruned)",
+                 config.lossModel);
+    cmd.AddValue("lossCacheThreshold",
+                 "Movement of either node that invalidates a cached pair loss (m)",
+                 config.lossCacheThreshold);
+    cmd.AddValue("pruneRange",
+                 "Cached loss model: receivers beyond this range get no signal (m, 0: off)",
+                 config.pruneRange);
+    cmd.AddValue("pruneRxPower",
+                 "Cached loss model: receivers below this mean Rx power get no signal (dBm)",
+                 config.pruneRxPower);
+    cmd.AddValue("seed", "RNG seed", config.seed);
+    cmd.AddValue("run", "RNG run number", config.run);
+}
+
+// Main function: entry point for the simulation
+int main(int argc, char *argv[])
+{
+    // Parse run-time options (passed by the Python script through Experiment.run)
+    CommandLine cmd(__FILE__);
+    AddScenarioOptions(cmd, g_config);
+    cmd.AddValue("ipcMode",
+                 "Python exchange mode: per-sta (one round trip per STA), "
+                 "batch (one round trip per report), vector (one round trip per "
+                 "queueDepth reports), async (batched, without blocking the simulation), "
+                 "ring (lock-free shared-memory rings, no round trip) or none (no Python "
+                 "peer, records go to telemetryFile)",
+                 g_ipcMode);
+    cmd.AddValue("wireFormat",
+                 "Records of batch mode: full (EnvBatchStruct) or compact (CompactBatchStruct: "
+                 "per-AP fields once per report, float32 per-STA values)",
+                 g_wireFormat);
+    cmd.AddValue("queueDepth", "Reports buffered per exchange in vector mode", g_queueDepth);
+    cmd.AddValue("actionLatency",
+                 "Reports before a Python action is applied in async mode",
+                 g_actionLatency);
+    cmd.AddValue("ringSlots",
+                 "Telemetry ring capacity in records in ring mode (a power of two)",
+                 g_ringSlots);
+    cmd.AddValue("shmPrefix",
+                 "Prefix of the ns3-ai shared memory names; concurrent runs need distinct "
+                 "prefixes (the default matches the ns3-ai defaults)",
+                 g_shmPrefix);
+    cmd.AddValue("telemetryFile",
+                 "Binary telemetry log written when ipcMode is none",
+                 g_telemetryFile);
+    cmd.AddValue("controller",
+                 "AP Tx power policy: python (reply from the Python peer), linear, "
+                 "hysteresis or pid (native, no round trip needed)",
+                 g_controller);
+    cmd.AddValue("minTxPower",
+                 "Lowest AP Tx power a native controller may choose (dBm)",
+                 g_controllerConfig.min_dbm);
+    cmd.AddValue("maxTxPower",
+                 "Highest AP Tx power a native controller may choose (dBm)",
+                 g_controllerConfig.max_dbm);
+    cmd.AddValue("hysteresisDb",
+                 "Dead band of the hysteresis controller (dB)",
+                 g_controllerConfig.hysteresis_db);
+    cmd.AddValue("pidSetpoint",
+                 "Target mean DL throughput of the PID controller (Mbps)",
+                 g_controllerConfig.setpoint_tp);
+    cmd.AddValue("pidKp", "Proportional gain of the PID controller", g_controllerConfig.kp);
+    cmd.AddValue("pidKi", "Integral gain of the PID controller", g_controllerConfig.ki);
+    cmd.AddValue("pidKd", "Derivative gain of the PID controller", g_controllerConfig.kd);
+    cmd.AddValue("verbosity",
+                 "Console output: 0 quiet, 1 per-report summary, 2 setup and per-STA "
+                 "lines, 3 per-message IPC traces (2 and 3 need a build with logging)",
+                 g_verbosity);
+    cmd.AddValue("flowMonitor",
+                 "Install FlowMonitor and report per-STA DL/UL delay, jitter and loss",
+                 g_flowStats);
+    cmd.AddValue("profile",
+                 "Record per-report wall-clock phase timings and print a summary at the end",
+                 g_profile);
+    cmd.AddValue("benchmarkFile",
+                 "Append the run's metrics (events/s, simulated s per wall s, IPC round trip "
+                 "percentiles, peak RSS) to this file as one JSON line",
+                 g_benchmarkFile);
+    cmd.AddValue("traceRecord",
+                 "Record every node position and link gain (fading included) every traceStep "
+                 "into this channel trace; the run's frames get the recorded gains",
+                 g_traceRecord);
+    cmd.AddValue("traceReplay",
+                 "Move the nodes and set every link gain from this channel trace (memory-mapped) "
+                 "instead of the random walk and the loss models",
+                 g_traceReplay);
+    cmd.AddValue("traceStep",
+                 "Time between two samples of a recorded channel trace (s, 0: interval)",
+                 g_traceStep);
+    cmd.AddValue("partitionRange",
+                 "Run groups of BSSs whose STA areas are at least this far apart (m) in "
+                 "separate processes (0: one process; needs ipcMode batch or none)",
+                 g_partitionRange);
+    cmd.AddValue("partitionProcs",
+                 "Most processes of a partitioned run (0: one per partition)",
+                 g_partitionProcs);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(g_config.nStas == 0, "nStas must be at least 1");
+    NS_ABORT_MSG_IF(g_config.nAps == 0 || g_config.nAps > WIFI_MAX_APS,
+                    "nAps must be between 1 and " << WIFI_MAX_APS);
+    NS_ABORT_MSG_IF(g_config.apTopology != "grid" && g_config.apTopology != "hex",
+                    "Unknown apTopology: " << g_config.apTopology);
+    NS_ABORT_MSG_IF(g_config.trafficModel != "cbr" && g_config.trafficModel != "poisson" &&
+                        g_config.trafficModel != "saturated",
+                    "Unknown trafficModel: " << g_config.trafficModel);
+    NS_ABORT_MSG_IF(g_config.packetSockets && !g_config.lean, "packetSockets needs lean");
+    NS_ABORT_MSG_IF(g_config.packetSockets && g_flowStats, "flowStats needs the IP stack");
+    NS_ABORT_MSG_IF(g_config.lossModel != "exact" && g_config.lossModel != "cached",
+                    "Unknown lossModel: " << g_config.lossModel);
+    NS_ABORT_MSG_IF(g_config.rateManager != "constant" && g_config.rateManager != "action" &&
+                        g_config.rateManager != "minstrel" && g_config.rateManager != "ideal",
+                    "Unknown rateManager: " << g_config.rateManager);
+    NS_ABORT_MSG_IF(g_config.interval <= 0.0, "interval must be positive");
+    NS_ABORT_MSG_IF(g_config.reportMode != "periodic" && g_config.reportMode != "change",
+                    "Unknown reportMode: " << g_config.reportMode);
+    NS_ABORT_MSG_IF(TrafficStartTime() >= g_config.totalTime,
+                    "trafficStart must be before totalTime");
+    NS_ABORT_MSG_IF(g_partitionRange > 0.0 && g_ipcMode != "batch" && g_ipcMode != "none",
+                    "Partitioned runs support ipcMode batch or none");
+    NS_ABORT_MSG_IF(g_wireFormat != "full" && g_wireFormat != "compact",
+                    "Unknown wireFormat: " << g_wireFormat);
+    NS_ABORT_MSG_IF(g_wireFormat == "compact" && (g_ipcMode != "batch" || g_partitionRange > 0.0),
+                    "wireFormat compact needs ipcMode batch in a single process");
+    NS_ABORT_MSG_IF(!g_traceRecord.empty() && !g_traceReplay.empty(),
+                    "traceRecord and traceReplay are exclusive");
+    NS_ABORT_MSG_IF((!g_traceRecord.empty() || !g_traceReplay.empty()) && g_partitionRange > 0.0,
+                    "Channel traces need a single process (no partitionRange)");
+    NS_ABORT_MSG_IF(g_traceStep < 0.0, "traceStep must not be negative");
+    NS_ABORT_MSG_IF(!g_traceRecord.empty() && g_config.lossModel == "cached",
+                    "traceRecord samples the exact loss chain (lossModel exact)");
+    if (!g_traceReplay.empty())
+    {
+        NS_ABORT_MSG_IF(!g_trace.reader.Open(g_traceReplay),
+                        "Cannot map channel trace " << g_traceReplay);
+        NS_ABORT_MSG_IF(g_trace.reader.GetApCount() != g_config.nAps ||
+                            g_trace.reader.GetNodeCount() != g_config.nAps + g_config.nStas,
+                        "Channel trace " << g_traceReplay << " has "
+                                         << g_trace.reader.GetApCount() << " APs and "
+                                         << g_trace.reader.GetNodeCount() << " nodes");
+        // Past the last sample positions would freeze and its gains be reused
+        NS_ABORT_MSG_IF(g_config.totalTime > g_trace.reader.GetDuration() + 1e-9,
+                        "Channel trace " << g_traceReplay << " covers only "
+                                         << g_trace.reader.GetDuration() << "s, below totalTime");
+    }
+    RngSeedManager::SetSeed(g_config.seed);
+    RngSeedManager::SetRun(g_config.run);
+    if (g_verbosity >= 2)
+    {
+        LogComponentEnable("WifiNetworkSimulation",
+                           g_verbosity >= 3 ? LOG_LEVEL_DEBUG : LOG_LEVEL_INFO);
+    }
+    g_profiler.SetEnabled(g_profile || !g_benchmarkFile.empty());
+    g_async.profiler.SetEnabled(g_profile || !g_benchmarkFile.empty());
+
+    // From here on every process of a partitioned run continues with its own APs
+    StartPartitions();
+
+    // Without a Python peer the Python rule runs as its C++ port
+    if (g_controller == "python" && g_ipcMode == "none")
+    {
+        g_controller = "linear";
+    }
+    if (g_controller != "python")
+    {
+        // One independent controller per AP of this process
+        for (uint32_t k = 0; k < g_localAps.size(); ++k)
+        {
+            g_txControllers.push_back(CreateTxPowerController(g_controller, g_controllerConfig));
+            NS_ABORT_MSG_IF(!g_txControllers.back(), "Unknown controller: " << g_controller);
+        }
+        NS_LOG_INFO("C++;main: Native AP Tx controller: " << g_txControllers[0]->GetName()
+                                                          << " x " << g_localAps.size());
+    }
+
+    // Initialize the AI message interface for communication with Python
+    if (g_rank != 0)
+    {
+        // Partition worker: its records go to the coordinator, which owns the interface
+    }
+    else if (g_ipcMode == "batch" || g_ipcMode == "async")
+    {
+        NS_ABORT_MSG_IF(g_config.nStas > WIFI_MAX_BATCH_STAS,
+                        "Batch mode supports at most " << WIFI_MAX_BATCH_STAS << " STAs");
+        if (g_wireFormat == "compact")
+        {
+            compactMsgInterface =
+                InitializeNs3AiInterface<CompactBatchStruct, ActBatchStruct>(false);
+        }
+        else
+        {
+            batchMsgInterface = InitializeNs3AiInterface<EnvBatchStruct, ActBatchStruct>(false);
+        }
+    }
+    else if (g_ipcMode == "vector")
+    {
+        NS_ABORT_MSG_IF(g_queueDepth == 0, "queueDepth must be at least 1");
+        msgInterface = InitializeNs3AiInterface<EnvStruct, ActStruct>(true);
+    }
+    else if (g_ipcMode == "per-sta")
+    {
+        msgInterface = InitializeNs3AiInterface<EnvStruct, ActStruct>(false);
+    }
+    else if (g_ipcMode == "ring")
+    {
+        NS_ABORT_MSG_IF(g_ringSlots == 0 || (g_ringSlots & (g_ringSlots - 1)) != 0 ||
+                            g_ringSlots < g_config.nStas,
+                        "ringSlots must be a power of two of at least nStas");
+        // Python opens the segment by the same name (see ShmRing in the bindings)
+        NS_ABORT_MSG_IF(!g_ring.Create("/" + g_shmPrefix + "WifiRing",
+                                       sizeof(EnvStruct),
+                                       g_ringSlots,
+                                       sizeof(ActBatchStruct),
+                                       RING_ACTION_SLOTS),
+                        "Cannot create shared-memory ring /" << g_shmPrefix << "WifiRing");
+        g_ring.Actions().AttachReader(0);
+    }
+    else if (g_ipcMode == "none")
+    {
+        // Telemetry-only run: no ns3-ai interface, no Python peer
+        NS_ABORT_MSG_IF(!g_telemetryLog.Open(g_telemetryFile, g_config.nStas),
+                        "Cannot open telemetry log " << g_telemetryFile);
+    }
+    else
+    {
+        NS_ABORT_MSG("Unknown ipcMode: " << g_ipcMode);
+    }
+
+    // Set up the WiFi scenario (nodes, devices, mobility, IP, UDP apps, etc.)
+    uint64_t bytesBefore = ResidentBytes();
+    InitializeScenario();
+    uint64_t bytesAfter = ResidentBytes();
+    g_scenarioBytes = bytesAfter > bytesBefore ? bytesAfter - bytesBefore : 0;
+    if (g_verbosity >= 1)
+    {
+        std::cout << "Scenario memory: " << g_scenarioBytes / 1024 << " KiB for "
+                  << wifiApNodes.GetN() + wifiStaNodes.GetN() << " nodes ("
+                  << ScenarioBytesPerNode() << " bytes per node"
+                  << (g_config.lean ? ", lean" : "") << ")\n";
+    }
+    if (!g_traceRecord.empty())
+    {
+        StartChannelTrace();
+    }
+
+    // Schedule periodic reporting of throughput and distance
+    Simulator::Schedule(Seconds(g_config.interval), &GetReport, Seconds(g_config.interval));
+
+    // Set simulation stop time and run the simulation
+    Simulator::Stop(Seconds(g_config.totalTime));
+    if (g_ipcMode == "async")
+    {
+        g_async.worker = std::thread(&AsyncExchangeWorker);
+    }
+    auto wallStart = std::chrono::steady_clock::now();
     Simulator::Run();
+    double wallSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    if (g_ipcMode == "async")
+    {
+        StopAsyncExchange();
+    }
+    if (g_ring.IsOpen())
+    {
+        // Let the controller read the last report before the segment is unlinked
+        g_ring.Telemetry().Close();
+        g_ring.Actions().Close();
+        NS_ABORT_MSG_IF(!g_ring.Telemetry().WaitConsumed(),
+                        "Controller exited before reading the last telemetry records");
+        g_ring.Close();
+    }
+    if (g_trace.writer.IsOpen())
+    {
+        // Last sample at totalTime when it falls on the sampling grid
+        SampleChannelUntil(g_config.totalTime);
+        if (g_verbosity >= 1)
+        {
+            std::cout << "Channel trace: " << g_trace.writer.GetSampleCount() << " samples of "
+                      << g_trace.positions.size() / 2 << " nodes and " << g_trace.gains.size()
+                      << " links written to " << g_traceRecord << "\n";
+        }
+        g_trace.writer.Close();
+    }
+    g_telemetryLog.Close();
+
+    // Coordinator: the workers finish together with the last report
+    for (uint32_t r = 0; r < g_workers.size(); ++r)
+    {
+        int status = 0;
+        g_workers[r].Close();
+        waitpid(g_workerPids[r], &status, 0);
+        NS_ABORT_MSG_IF(!WIFEXITED(status) || WEXITSTATUS(status) != 0,
+                        "Partition worker " << r + 1 << " failed");
+    }
+
+    if (g_verbosity >= 1)
+    {
+        std::cout << "Association: " << g_associatedStas << "/" << g_sta.Size()
+                  << " STAs, last at " << g_lastAssociation.GetSeconds() << "s (traffic from "
+                  << TrafficStartTime() << "s)\n";
+    }
+    if (g_config.reportMode == "change" && g_verbosity >= 1)
+    {
+        std::cout << "Change-driven reports: " << g_reportSeq << " sent of " << g_reportChecks
+                  << " checks\n";
+    }
+    if (g_cachedLoss && g_verbosity >= 1)
+    {
+        std::cout << "Loss cache: " << g_cachedLoss->GetHitCount() << " hits, "
+                  << g_cachedLoss->GetMissCount() << " misses, " << g_cachedLoss->GetPrunedCount()
+                  << " receivers pruned\n";
+    }
+    if (g_profile)
+    {
+        // Reports vs. everything else (NS-3 event processing) on the simulation thread
+        double simSeconds = Simulator::Now().GetSeconds();
+        double reportSeconds = g_profiler.GetTotalSeconds();
+        g_profiler.Print(std::cout, "GetReport profile (" + g_ipcMode + ")");
+        if (g_ipcMode == "async")
+        {
+            g_async.profiler.Print(std::cout, "Async IPC worker profile");
+            std::cout << "Async reports dropped: " << g_async.dropped << " (queue of "
+                      << g_actionLatency + 1 << " reports)\n";
+        }
+        std::cout << "Wall time: " << wallSeconds << "s, simulated: " << simSeconds << "s, "
+                  << (wallSeconds > 0.0 ? simSeconds / wallSeconds : 0.0)
+                  << " simulated s per wall s\n"
+                  << "Reports: " << reportSeconds << "s ("
+                  << (wallSeconds > 0.0 ? 100.0 * reportSeconds / wallSeconds : 0.0)
+                  << "% of wall time), event processing: " << wallSeconds - reportSeconds
+                  << "s\n";
+    }
+    if (!g_benchmarkFile.empty())
+    {
+        WriteBenchmarkRecord(wallSeconds);
+    }
     Simulator::Destroy();
     return 0;
 }
\ No newline at end of file
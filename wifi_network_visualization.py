@@ -36,7 +36,8 @@ Key Features:
 - Export capabilities for presentation/analysis
 
 Data Sources:
-- toy_data.csv: Simulation results from toy1.py
+- toy_data.csv / .parquet / .arrow: Simulation results from wifi_analysis_and_control.py
+- Telemetry logs (.bin) of telemetry-only runs
 - Real-time data during simulation (optional)
 - Network topology and performance metrics
 
@@ -56,10 +57,18 @@ import numpy as np
 from tqdm import tqdm
 
 # Standard libraries for file operations and system utilities
+import argparse
+import multiprocessing
 import os
+import subprocess
 import sys
+import tempfile
+import types
 from datetime import datetime
 
+# Record files of any supported format, with column projection
+from wifi_recorder import read_records
+
 print("WiFi Network Animation - Starting visualization setup...")
 
 # === FILE SYSTEM AND DATA LOADING ===
@@ -70,120 +79,375 @@ Setup data input paths and load simulation results:
 - Prepare data structures for animation
 """
 script_dir = os.path.dirname(os.path.abspath(__file__))
-csv_path = os.path.join(script_dir, "toy_data.csv")
-df = pd.read_csv(csv_path)
+parser = argparse.ArgumentParser(description="WiFi STA animation")
+parser.add_argument(
+    "input",
+    nargs="?",
+    default=os.path.join(script_dir, "toy_data.csv"),
+    help="CSV, Parquet, Arrow IPC or telemetry log (.bin) (default: toy_data.csv)",
+)
+parser.add_argument(
+    "--mode",
+    choices=["classic", "fast", "overview"],
+    default="classic",
+    help="classic: redraw every frame from the DataFrame; fast: pre-binned frames, persistent "
+    "artists and blitting; overview: fast with at most --max-frames evenly spaced timesteps "
+    "and no per-STA labels (default: classic)",
+)
+parser.add_argument(
+    "-o",
+    "--output",
+    default="sta_animation.gif",
+    help="animation file, .gif or .mp4 (default: sta_animation.gif)",
+)
+parser.add_argument("--fps", type=int, default=5, help="frames per second (default: 5)")
+parser.add_argument(
+    "--workers",
+    type=int,
+    default=1,
+    help="fast and overview: render frames in this many processes, then encode them "
+    "(default: 1, render while encoding)",
+)
+parser.add_argument(
+    "--max-frames",
+    type=int,
+    default=300,
+    help="overview: most frames of the animation (default: 300)",
+)
+parser.add_argument(
+    "--labels",
+    choices=["auto", "on", "off"],
+    default="auto",
+    help="fast: STA numbers and DL/distance boxes (auto: with at most 32 STAs)",
+)
+parser.add_argument(
+    "--show", action="store_true", help="fast and overview: play in a window instead of saving"
+)
+args = parser.parse_args()
+for name in ("fps", "workers", "max_frames"):
+    if getattr(args, name) < 1:
+        parser.error(f"--{name.replace('_', '-')} must be at least 1")
+
+# Only the columns the animation draws are parsed (Parquet/Arrow/telemetry logs
+# skip the others entirely)
+COLUMNS = ["now_sec", "sta_id", "pos_x", "pos_y", "distance", "dl_tp", "ul_tp", "set_ApTx"]
+df = read_records(args.input, COLUMNS)
 mlim = max(df["pos_x"].abs().max(), df["pos_y"].abs().max()) + 1
 
-# Create figure and axis
-fig, ax = plt.subplots(figsize=(10, 8))
-ax.set_xlim(-mlim, mlim)
-ax.set_ylim(-mlim, mlim)
-ax.grid(True)
-ax.set_title("WiFi STA Animation")
 
-# AP position (center)
-ap = ax.scatter([0], [0], c="red", s=100, label="AP")
+# === CLASSIC ANIMATION ===
+def animate_classic():
+    """Original animation: every frame filters the DataFrame and recreates its texts"""
+    # Create figure and axis
+    fig, ax = plt.subplots(figsize=(10, 8))
+    ax.set_xlim(-mlim, mlim)
+    ax.set_ylim(-mlim, mlim)
+    ax.grid(True)
+    ax.set_title("WiFi STA Animation")
 
-# STA containers (hollow markers with STA numbers)
-scat = ax.scatter(
-    [], [], facecolors="none", edgecolors="blue", s=250, label="STA", linewidths=2
-)
-time_text = ax.text(0.05, 0.9, "", transform=ax.transAxes)
-annotations = []
-sta_texts = []
-
-
-def init():
-    scat.set_offsets(np.empty((0, 2)))
-    time_text.set_text("")
-    for txt in sta_texts:
-        txt.remove()
-    sta_texts.clear()
-    return scat, time_text
-
-
-def update(frame):
-    current_time = df["now_sec"].unique()[frame]
-    current_data = df[df["now_sec"] == current_time]
-
-    # Update STA positions
-    scat.set_offsets(current_data[["pos_x", "pos_y"]].values)
-
-    # Clear previous elements
-    for ann in annotations:
-        ann.remove()
-    annotations.clear()
-
-    for txt in sta_texts:
-        txt.remove()
-    sta_texts.clear()
-
-    # Add STA numbers inside markers
-    for _, row in current_data.iterrows():
-        txt = ax.text(
-            row["pos_x"],
-            row["pos_y"],
-            str(int(row["sta_id"])),
-            color="blue",
-            ha="center",
-            va="center",
-            fontsize=10,
-            fontweight="bold",
-        )
-        sta_texts.append(txt)
-
-    # Create adjacent annotation boxes
-    for _, row in current_data.iterrows():
-        text = f"DL: {row['dl_tp']:.2f} Mbps\nDist: {row['distance']:.2f}m"
-        ann = ax.text(
-            row["pos_x"] + 0.01,  # Right offset
-            row["pos_y"] + 0.01,  # Upper offset
-            text,
-            bbox=dict(facecolor="white", alpha=0.8, boxstyle="round,pad=0.2"),
-            fontsize=9,
-            ha="left",
-            va="bottom",
+    # AP position (center)
+    ax.scatter([0], [0], c="red", s=100, label="AP")
+
+    # STA containers (hollow markers with STA numbers)
+    scat = ax.scatter(
+        [], [], facecolors="none", edgecolors="blue", s=250, label="STA", linewidths=2
+    )
+    time_text = ax.text(0.05, 0.9, "", transform=ax.transAxes)
+    annotations = []
+    sta_texts = []
+
+    def init():
+        scat.set_offsets(np.empty((0, 2)))
+        time_text.set_text("")
+        for txt in sta_texts:
+            txt.remove()
+        sta_texts.clear()
+        return scat, time_text
+
+    def update(frame):
+        current_time = df["now_sec"].unique()[frame]
+        current_data = df[df["now_sec"] == current_time]
+
+        # Update STA positions
+        scat.set_offsets(current_data[["pos_x", "pos_y"]].values)
+
+        # Clear previous elements
+        for ann in annotations:
+            ann.remove()
+        annotations.clear()
+
+        for txt in sta_texts:
+            txt.remove()
+        sta_texts.clear()
+
+        # Add STA numbers inside markers
+        for _, row in current_data.iterrows():
+            txt = ax.text(
+                row["pos_x"],
+                row["pos_y"],
+                str(int(row["sta_id"])),
+                color="blue",
+                ha="center",
+                va="center",
+                fontsize=10,
+                fontweight="bold",
+            )
+            sta_texts.append(txt)
+
+        # Create adjacent annotation boxes
+        for _, row in current_data.iterrows():
+            text = f"DL: {row['dl_tp']:.2f} Mbps\nDist: {row['distance']:.2f}m"
+            ann = ax.text(
+                row["pos_x"] + 0.01,  # Right offset
+                row["pos_y"] + 0.01,  # Upper offset
+                text,
+                bbox=dict(facecolor="white", alpha=0.8, boxstyle="round,pad=0.2"),
+                fontsize=9,
+                ha="left",
+                va="bottom",
+            )
+            annotations.append(ann)
+
+        total_ul = current_data["ul_tp"].mean()
+        total_dl = current_data["dl_tp"].sum()
+        ApTx = current_data["set_ApTx"].mean()
+        time_text.set_text(
+            f"Ap Tx power: {ApTx:.2f} dB\n"
+            f"Total DL: {total_dl:.2f} Mbps\n"
+            f"Total UL: {total_ul:.2f} Mbps\n"
+            f"Time: {current_time:.2f}s"
         )
-        annotations.append(ann)
-
-    total_ul = current_data["ul_tp"].mean()
-    total_dl = current_data["dl_tp"].sum()
-    ApTx = current_data["set_ApTx"].mean()
-    time_text.set_text(
-        f"Ap Tx power: {ApTx:.2f} dB\n"
-        f"Total DL: {total_dl:.2f} Mbps\n"
-        f"Total UL: {total_ul:.2f} Mbps\n"
-        f"Time: {current_time:.2f}s"
+
+        return scat, time_text, *annotations, *sta_texts
+
+    # Animation setup
+    frames = len(df["now_sec"].unique())
+    pbar = tqdm(total=frames, desc="Rendering frames")
+
+    def progress_callback(current_frame, total_frames):
+        pbar.n = current_frame
+        pbar.refresh()
+
+    ani = animation.FuncAnimation(
+        fig,
+        update,
+        frames=frames,
+        init_func=init,
+        interval=1000 / args.fps,
+        blit=False,
+    )
+
+    plt.legend()
+    ani.save(
+        args.output,
+        writer="imagemagick" if args.output.lower().endswith(".gif") else "ffmpeg",
+        fps=args.fps,
+        progress_callback=progress_callback,
     )
+    pbar.close()
+    print(f"Animation saved to {args.output}")
 
-    return scat, time_text, *annotations, *sta_texts
 
+# === PRE-BINNED FRAMES ===
+def bin_frames(max_frames=None):
+    """
+    Pre-bin the trace per timestep into NumPy arrays: one row per frame, one column per
+    STA (NaN where a STA has no record at that time), plus the per-frame totals.
+    max_frames keeps at most that many evenly spaced timesteps (overview).
+    """
+    times, frame = np.unique(df["now_sec"].to_numpy(), return_inverse=True)
+    sta_ids, sta = np.unique(df["sta_id"].to_numpy(), return_inverse=True)
+    keep = np.arange(len(times))
+    if max_frames and len(times) > max_frames:
+        keep = np.unique(np.linspace(0, len(times) - 1, max_frames).round().astype(np.int64))
 
-# Animation setup
-frames = len(df["now_sec"].unique())
-pbar = tqdm(total=frames, desc="Rendering frames")
+    def grid(column):
+        values = np.full((len(times), len(sta_ids)), np.nan)
+        values[frame, sta] = df[column].to_numpy()
+        return values[keep]
 
+    dl = grid("dl_tp")
+    return types.SimpleNamespace(
+        times=times[keep],
+        sta_ids=sta_ids,
+        x=grid("pos_x"),
+        y=grid("pos_y"),
+        dl=dl,
+        distance=grid("distance"),
+        total_dl=np.nansum(dl, axis=1),
+        mean_ul=np.nanmean(grid("ul_tp"), axis=1),
+        ap_tx=np.nanmean(grid("set_ApTx"), axis=1),
+    )
 
-def progress_callback(current_frame, total_frames):
-    pbar.n = current_frame
-    pbar.refresh()
 
+class FrameRenderer:
+    """
+    Figure whose artists are created once; update(i) only changes their data,
+    so (with blitting) a frame redraws just the STA markers and texts
+    """
 
-ani = animation.FuncAnimation(
-    fig,
-    update,
-    frames=frames,
-    init_func=init,
-    interval=200,
-    blit=False,
-)
+    def __init__(self, frames, labels):
+        self.frames = frames
+        self.fig, ax = plt.subplots(figsize=(10, 8))
+        ax.set_xlim(-mlim, mlim)
+        ax.set_ylim(-mlim, mlim)
+        ax.grid(True)
+        ax.set_title("WiFi STA Animation")
+        ax.scatter([0], [0], c="red", s=100, label="AP")
+        self.scat = ax.scatter(
+            [], [], facecolors="none", edgecolors="blue", s=250, label="STA", linewidths=2
+        )
+        ax.legend()
+        self.time_text = ax.text(0.05, 0.9, "", transform=ax.transAxes)
 
-plt.legend()
-ani.save(
-    "sta_animation.gif",
-    writer="imagemagick",
-    fps=5,
-    progress_callback=progress_callback,
-)
-pbar.close()
-print("Animation saved to sta_animation.gif")
+        # One STA number and one DL/distance box per STA, hidden while the STA has no record
+        self.sta_texts = []
+        self.annotations = []
+        for sta_id in frames.sta_ids if labels else []:
+            self.sta_texts.append(
+                ax.text(
+                    0,
+                    0,
+                    str(int(sta_id)),
+                    color="blue",
+                    ha="center",
+                    va="center",
+                    fontsize=10,
+                    fontweight="bold",
+                    visible=False,
+                )
+            )
+            self.annotations.append(
+                ax.text(
+                    0,
+                    0,
+                    "",
+                    bbox=dict(facecolor="white", alpha=0.8, boxstyle="round,pad=0.2"),
+                    fontsize=9,
+                    ha="left",
+                    va="bottom",
+                    visible=False,
+                )
+            )
+
+    def artists(self):
+        """Every artist update() may change"""
+        return [self.scat, self.time_text, *self.sta_texts, *self.annotations]
+
+    def update(self, i):
+        """Show frame i; return the artists to redraw"""
+        f = self.frames
+        x, y = f.x[i], f.y[i]
+        present = ~np.isnan(x)
+        self.scat.set_offsets(np.column_stack((x[present], y[present])))
+        for s in range(len(self.sta_texts)):
+            self.sta_texts[s].set_visible(present[s])
+            self.annotations[s].set_visible(present[s])
+            if present[s]:
+                self.sta_texts[s].set_position((x[s], y[s]))
+                self.annotations[s].set_position((x[s] + 0.01, y[s] + 0.01))
+                self.annotations[s].set_text(
+                    f"DL: {f.dl[i, s]:.2f} Mbps\nDist: {f.distance[i, s]:.2f}m"
+                )
+        self.time_text.set_text(
+            f"Ap Tx power: {f.ap_tx[i]:.2f} dB\n"
+            f"Total DL: {f.total_dl[i]:.2f} Mbps\n"
+            f"Total UL: {f.mean_ul[i]:.2f} Mbps\n"
+            f"Time: {f.times[i]:.2f}s"
+        )
+        return self.artists()
+
+
+# === PARALLEL FRAME RENDERING ===
+"""
+With --workers > 1 the frames are split into contiguous chunks, each rendered to
+PNG files by a forked worker process (which inherits the pre-binned arrays), and
+the PNGs are encoded afterwards: GIF with Pillow, anything else with ffmpeg.
+"""
+FRAMES = None  # Pre-binned frames, set before the workers are forked
+LABELS = False  # Per-STA labels of the workers' renderers
+
+
+def render_chunk(job):
+    """Render frames (first, last) to frame_<index>.png in directory; return the count"""
+    (first, last), directory = job
+    renderer = FrameRenderer(FRAMES, LABELS)
+    for i in range(first, last):
+        renderer.update(i)
+        renderer.fig.savefig(os.path.join(directory, f"frame_{i:06d}.png"))
+    plt.close(renderer.fig)
+    return last - first
+
+
+def encode_frames(directory, count, output, fps):
+    """Encode frame_000000.png .. frame_<count-1>.png into output"""
+    paths = [os.path.join(directory, f"frame_{i:06d}.png") for i in range(count)]
+    if output.lower().endswith(".gif"):
+        from PIL import Image
+
+        first = Image.open(paths[0])
+        first.save(
+            output,
+            save_all=True,
+            append_images=(Image.open(path) for path in paths[1:]),
+            duration=1000 // fps,
+            loop=0,
+        )
+    else:
+        subprocess.run(
+            ["ffmpeg", "-y", "-loglevel", "error", "-framerate", str(fps)]
+            + ["-i", os.path.join(directory, "frame_%06d.png"), "-pix_fmt", "yuv420p", output],
+            check=True,
+        )
+
+
+def animate_fast(max_frames, labels):
+    """Pre-binned frames drawn with persistent artists, sequentially or in worker processes"""
+    global FRAMES, LABELS
+    FRAMES = bin_frames(max_frames)
+    LABELS = labels
+    count = len(FRAMES.times)
+    print(f"{count} frames of {len(FRAMES.sta_ids)} STAs pre-binned from {len(df)} records")
+
+    if args.show or args.workers <= 1:
+        renderer = FrameRenderer(FRAMES, LABELS)
+        ani = animation.FuncAnimation(
+            renderer.fig,
+            renderer.update,
+            frames=count,
+            init_func=renderer.artists,
+            interval=1000 // args.fps,
+            blit=True,
+        )
+        if args.show:
+            plt.show()
+            return
+        with tqdm(total=count, desc="Rendering frames") as pbar:
+            ani.save(
+                args.output,
+                writer="pillow" if args.output.lower().endswith(".gif") else "ffmpeg",
+                fps=args.fps,
+                progress_callback=lambda current, total: pbar.update(current + 1 - pbar.n),
+            )
+    else:
+        bounds = np.linspace(0, count, args.workers * 4 + 1).round().astype(np.int64)
+        chunks = [(int(a), int(b)) for a, b in zip(bounds[:-1], bounds[1:]) if b > a]
+        with tempfile.TemporaryDirectory() as directory:
+            with multiprocessing.get_context("fork").Pool(args.workers) as pool:
+                jobs = [(chunk, directory) for chunk in chunks]
+                with tqdm(total=count, desc=f"Rendering frames ({args.workers} workers)") as pbar:
+                    for rendered in pool.imap_unordered(render_chunk, jobs):
+                        pbar.update(rendered)
+            print("Encoding frames...")
+            encode_frames(directory, count, args.output, args.fps)
+    print(f"Animation saved to {args.output}")
+
+
+if args.mode == "classic":
+    animate_classic()
+else:
+    overview = args.mode == "overview"
+    labels = args.labels == "on" or (
+        args.labels == "auto" and not overview and df["sta_id"].nunique() <= 32
+    )
+    animate_fast(args.max_frames if overview else None, labels)
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Texas State University
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+# Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+# PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+# Texas State University
+
+"""
+WiFi Network Simulation - Online Statistics
+
+Streaming statistics of the per-STA records for wifi_analysis_and_control.py,
+updated with whole arrays of records (one NumPy pass per report) instead of
+per-sample Python lists:
+- KeyedStats: count, mean and variance (Welford, merged batch by batch) and an
+  EWMA of the interval means, one set per key (STA or BSS)
+- QuantileSketch: fixed-bin histogram per key, quantiles to within one bin;
+  values outside its range are counted as clipped
+- OnlineStats: the run's statistics by STA, BSS and interval. An interval is
+  complete once all records of a report have arrived. Records can come as
+  whole reports (batch, vector and ring loops) or one at a time (per-STA
+  loop), so decisions are made exactly once per interval.
+"""
+
+from collections import namedtuple
+
+import numpy as np
+
+# Highest 802.11n PHY rate (Mbps): MCS 31, 4 spatial streams, 40 MHz, short guard interval
+HT_MAX_RATE = 600.0
+
+# Statistics of one complete interval (report)
+IntervalSummary = namedtuple(
+    "IntervalSummary", ["index", "now_sec", "mean_dl", "bss_mean_dl", "dl_p50", "dl_p95"]
+)
+
+
+class KeyedStats:
+    """Count, mean, variance and EWMA of one value per key"""
+
+    def __init__(self, n_keys, alpha=0.2):
+        """
+        n_keys: number of keys (values are keyed 0..n_keys-1)
+        alpha: EWMA weight of the newest interval mean
+        """
+        self.alpha = alpha
+        self.count = np.zeros(n_keys, dtype=np.int64)
+        self.mean = np.zeros(n_keys)
+        self.m2 = np.zeros(n_keys)  # Sum of squared deviations from the mean
+        self.ewma = np.full(n_keys, np.nan)  # NaN until the key's first value
+
+    def update(self, keys, values):
+        """Add one interval of values (keys and values: equally long arrays)"""
+        n_keys = len(self.count)
+        n = np.bincount(keys, minlength=n_keys)
+        total = np.bincount(keys, weights=values, minlength=n_keys)
+        has = n > 0
+        batch_mean = np.divide(total, n, out=np.zeros(n_keys), where=has)
+        batch_m2 = np.bincount(keys, weights=(values - batch_mean[keys]) ** 2, minlength=n_keys)
+
+        # Merge the batch into the running moments (Chan et al.)
+        count = self.count[has] + n[has]
+        delta = batch_mean[has] - self.mean[has]
+        self.mean[has] += delta * n[has] / count
+        self.m2[has] += batch_m2[has] + delta**2 * self.count[has] * n[has] / count
+        self.count[has] = count
+
+        prev = self.ewma[has]
+        self.ewma[has] = np.where(
+            np.isnan(prev), batch_mean[has], prev + self.alpha * (batch_mean[has] - prev)
+        )
+
+    def variance(self):
+        """Sample variance of every key (0 below two values)"""
+        return np.divide(
+            self.m2, self.count - 1, out=np.zeros(len(self.count)), where=self.count > 1
+        )
+
+
+class QuantileSketch:
+    """Fixed-bin histogram of one value per key; quantiles to within one bin width"""
+
+    def __init__(self, n_keys, low, high, bins=256):
+        """
+        n_keys: number of keys
+        low, high: value range of the bins (values outside go to the first/last bin)
+        bins: number of bins per key
+        """
+        self.low = low
+        self.high = high
+        self.width = (high - low) / bins
+        self.counts = np.zeros((n_keys, bins), dtype=np.int64)
+        self.clipped = np.zeros(n_keys, dtype=np.int64)  # Values outside [low, high]
+
+    def update(self, keys, values):
+        """Add values (keys and values: equally long arrays)"""
+        n_keys, bins = self.counts.shape
+        outside = (values < self.low) | (values > self.high)
+        if outside.any():
+            self.clipped += np.bincount(keys[outside], minlength=n_keys)
+        index = np.clip(((values - self.low) / self.width).astype(np.int64), 0, bins - 1)
+        self.counts += np.bincount(keys * bins + index, minlength=n_keys * bins).reshape(
+            n_keys, bins
+        )
+
+    def quantile(self, q):
+        """q-quantile of every key (bin centre, NaN for keys without values)"""
+        cumulative = np.cumsum(self.counts, axis=1)
+        total = cumulative[:, -1]
+        index = (cumulative < np.maximum(q * total, 1)[:, None]).sum(axis=1)
+        values = self.low + (np.minimum(index, self.counts.shape[1] - 1) + 0.5) * self.width
+        return np.where(total > 0, values, np.nan)
+
+
+class OnlineStats:
+    """Per-STA, per-BSS and per-interval statistics of a run's records"""
+
+    def __init__(
+        self, n_stas, n_aps, record_dtype, alpha=0.2, dl_range=(0.0, HT_MAX_RATE), dl_bins=512
+    ):
+        """
+        n_stas, n_aps: scenario size (records per interval, BSS count)
+        record_dtype: dtype of the records (ENV_DTYPE)
+        alpha: EWMA weight of the newest interval
+        dl_range: DL throughput range of the quantile sketches (Mbps, default: up to
+                  the highest 802.11n PHY rate); values outside are clipped
+        dl_bins: bins per STA of the quantile sketches
+        """
+        self.n_aps = n_aps
+        self.sta_dl = KeyedStats(n_stas, alpha)
+        self.sta_snr = KeyedStats(n_stas, alpha)
+        self.bss_dl = KeyedStats(n_aps, alpha)
+        self.sta_dl_sketch = QuantileSketch(n_stas, *dl_range, bins=dl_bins)
+        self.intervals = 0
+        self.mean_dl = None  # Mean DL of the last complete interval, all STAs
+        self.bss_mean_dl = np.full(n_aps, np.nan)  # Mean DL of the last interval per BSS
+        self.pending = np.zeros(n_stas, dtype=record_dtype)  # Records of the open interval
+        self.fill = 0
+
+    def add_report(self, report):
+        """Add the records of one complete interval; return its IntervalSummary"""
+        sta_id, ap_id = report["sta_id"], report["ap_id"]
+        dl_tp = report["dl_tp"]
+        self.sta_dl.update(sta_id, dl_tp)
+        self.sta_snr.update(sta_id, report["snr"])
+        self.sta_dl_sketch.update(sta_id, dl_tp)
+
+        bss_stas = np.bincount(ap_id, minlength=self.n_aps)
+        bss_sum = np.bincount(ap_id, weights=dl_tp, minlength=self.n_aps)
+        self.bss_dl.update(ap_id, dl_tp)
+        # BSSs without records keep the mean of their last interval
+        np.divide(bss_sum, bss_stas, out=self.bss_mean_dl, where=bss_stas > 0)
+        if len(report):
+            self.mean_dl = float(dl_tp.mean())
+            dl_p50, dl_p95 = np.percentile(dl_tp, [50, 95])
+        else:
+            dl_p50 = dl_p95 = np.nan
+        self.intervals += 1
+        return IntervalSummary(
+            self.intervals - 1,
+            float(report["now_sec"][0]) if len(report) else np.nan,
+            self.mean_dl,
+            self.bss_mean_dl.copy(),
+            dl_p50,
+            dl_p95,
+        )
+
+    def add_record(self, record):
+        """
+        Add one record of a report sent record by record; return the IntervalSummary
+        once the interval's last record has arrived, else None
+        """
+        self.pending[self.fill : self.fill + 1] = record  # A one-record view or a scalar
+        self.fill += 1
+        if self.fill < len(self.pending):
+            return None
+        self.fill = 0
+        return self.add_report(self.pending)
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2025 Texas State University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+ * PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+ * Texas State University
+ */
+
+/**
+ * @file wifi_partition.h
+ * @brief Spatially independent AP partitions and the link between their processes
+ *
+ * A partitioned run simulates groups of BSSs that cannot hear each other in
+ * separate processes, one ns-3 simulation each (the ns-3 simulator is a
+ * process-wide singleton, so partitions cannot share a process):
+ * - STAs of a partition walk only inside the bounding box of its APs
+ *   extended by mobilityBound (its area)
+ * - PartitionAps() merges APs into partitions until any two areas are at
+ *   least the given range apart, e.g. beyond the range at which a frame still
+ *   exceeds the Rx sensitivity
+ * - PartitionLink carries the per-report records and the reply between the
+ *   coordinator (the process talking to Python) and each worker process
+ */
+
+#ifndef WIFI_PARTITION_H
+#define WIFI_PARTITION_H
+
+#include "ns3/vector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @struct PartitionArea
+ * @brief Rectangle the STAs of a partition can reach
+ */
+struct PartitionArea
+{
+    double minX; ///< Lowest x (m)
+    double maxX; ///< Highest x (m)
+    double minY; ///< Lowest y (m)
+    double maxY; ///< Highest y (m)
+};
+
+/**
+ * Area of a group of APs
+ * @param positions Position of every AP
+ * @param aps Indices of the group's APs (not empty)
+ * @param margin Distance STAs may walk beyond the outermost APs (m)
+ * @return Bounding box of the APs extended by margin
+ */
+inline PartitionArea
+ApGroupArea(const std::vector<ns3::Vector> &positions,
+            const std::vector<uint32_t> &aps,
+            double margin)
+{
+    PartitionArea area{positions[aps[0]].x,
+                       positions[aps[0]].x,
+                       positions[aps[0]].y,
+                       positions[aps[0]].y};
+    for (uint32_t k : aps)
+    {
+        area.minX = std::min(area.minX, positions[k].x);
+        area.maxX = std::max(area.maxX, positions[k].x);
+        area.minY = std::min(area.minY, positions[k].y);
+        area.maxY = std::max(area.maxY, positions[k].y);
+    }
+    area.minX -= margin;
+    area.maxX += margin;
+    area.minY -= margin;
+    area.maxY += margin;
+    return area;
+}
+
+/**
+ * @param a First area
+ * @param b Second area
+ * @return Shortest distance between two points of the areas (0 if they overlap)
+ */
+inline double
+AreaGap(const PartitionArea &a, const PartitionArea &b)
+{
+    double dx = std::max({0.0, b.minX - a.maxX, a.minX - b.maxX});
+    double dy = std::max({0.0, b.minY - a.maxY, a.minY - b.maxY});
+    return std::hypot(dx, dy);
+}
+
+/**
+ * Group APs into partitions whose areas are at least range apart
+ * @param positions Position of every AP
+ * @param margin Distance STAs may walk beyond the outermost APs of their partition (m)
+ * @param range Smallest gap between the areas of two partitions (m)
+ * @return Partition of every AP, numbered in the order of their lowest AP index
+ */
+inline std::vector<uint32_t>
+PartitionAps(const std::vector<ns3::Vector> &positions, double margin, double range)
+{
+    // Single linkage: start with one partition per AP, merge the first close pair until none
+    std::vector<std::vector<uint32_t>> groups;
+    for (uint32_t k = 0; k < positions.size(); ++k)
+    {
+        groups.push_back({k});
+    }
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (std::size_t a = 0; a < groups.size() && !merged; ++a)
+        {
+            PartitionArea areaA = ApGroupArea(positions, groups[a], margin);
+            for (std::size_t b = a + 1; b < groups.size() && !merged; ++b)
+            {
+                if (AreaGap(areaA, ApGroupArea(positions, groups[b], margin)) < range)
+                {
+                    groups[a].insert(groups[a].end(), groups[b].begin(), groups[b].end());
+                    groups.erase(groups.begin() + b);
+                    merged = true;
+                }
+            }
+        }
+    }
+
+    std::vector<uint32_t> partition(positions.size());
+    for (uint32_t g = 0; g < groups.size(); ++g)
+    {
+        for (uint32_t k : groups[g])
+        {
+            partition[k] = g;
+        }
+    }
+    return partition;
+}
+
+/**
+ * @class PartitionLink
+ * @brief Blocking stream socket between the coordinator and one partition worker
+ *
+ * Carries trivially copyable values and vectors of them; the two sides run the
+ * same report schedule, so every read is matched by a write in the same report.
+ */
+class PartitionLink
+{
+  public:
+    /// @param fd Connected socket (one end of a socketpair), -1 for none
+    explicit PartitionLink(int fd = -1)
+        : m_fd(fd)
+    {
+    }
+
+    /**
+     * @param data Bytes to send
+     * @param size Number of bytes
+     * @return false if the peer has closed the link
+     */
+    bool Write(const void *data, std::size_t size) const
+    {
+        const char *bytes = static_cast<const char *>(data);
+        while (size > 0)
+        {
+            // MSG_NOSIGNAL: a dead peer is an error return, not SIGPIPE
+            ssize_t sent = send(m_fd, bytes, size, MSG_NOSIGNAL);
+            if (sent <= 0)
+            {
+                return false;
+            }
+            bytes += sent;
+            size -= sent;
+        }
+        return true;
+    }
+
+    /**
+     * @param data Destination of the bytes
+     * @param size Number of bytes
+     * @return false if the peer has closed the link
+     */
+    bool Read(void *data, std::size_t size) const
+    {
+        char *bytes = static_cast<char *>(data);
+        while (size > 0)
+        {
+            ssize_t received = recv(m_fd, bytes, size, 0);
+            if (received <= 0)
+            {
+                return false;
+            }
+            bytes += received;
+            size -= received;
+        }
+        return true;
+    }
+
+    /**
+     * Send a vector as its element count followed by the elements
+     * @param values Elements to send
+     * @return false if the peer has closed the link
+     */
+    template <typename T>
+    bool WriteVector(const std::vector<T> &values) const
+    {
+        uint32_t count = values.size();
+        return Write(&count, sizeof(count)) && Write(values.data(), count * sizeof(T));
+    }
+
+    /**
+     * Receive a vector sent by WriteVector() and append its elements
+     * @param values Vector the elements are appended to
+     * @return false if the peer has closed the link
+     */
+    template <typename T>
+    bool AppendVector(std::vector<T> &values) const
+    {
+        uint32_t count = 0;
+        if (!Read(&count, sizeof(count)))
+        {
+            return false;
+        }
+        std::size_t offset = values.size();
+        values.resize(offset + count);
+        return Read(values.data() + offset, count * sizeof(T));
+    }
+
+    /// Close the socket (the peer's next read or write fails)
+    void Close()
+    {
+        if (m_fd >= 0)
+        {
+            close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+  private:
+    int m_fd; ///< Socket, -1 when closed
+};
+
+#endif // WIFI_PARTITION_H
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2025 Texas State University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+ * PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+ * Texas State University
+ */
+
+/**
+ * @file wifi_profiler.h
+ * @brief Wall-clock profiling of the per-report hot path
+ *
+ * Splits the wall time of every GetReport() invocation into phases:
+ * - stats: throughput, position and distance collection
+ * - ipc_send: writing records into shared memory (including waiting for the slot)
+ * - ipc_wait: waiting for the Python reply
+ * - tx_update: native controller decision and applying the new AP Tx power
+ * - other: the rest of the report, mostly console output
+ * and reports p50/p95/p99 per phase plus a histogram of the total report time.
+ *
+ * A disabled profiler, or a null ReportProfiler pointer given to a
+ * ProfileScope, costs one branch and never reads the clock.
+ */
+
+#ifndef WIFI_PROFILER_H
+#define WIFI_PROFILER_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Profiled phases of a report
+enum ProfilePhase : uint8_t
+{
+    PROFILE_STATS = 0,
+    PROFILE_IPC_SEND,
+    PROFILE_IPC_WAIT,
+    PROFILE_TX_UPDATE,
+    PROFILE_PHASE_COUNT
+};
+
+/**
+ * @class ReportProfiler
+ * @brief Per-report phase timings with percentile and histogram summaries
+ *
+ * Not thread-safe: every thread that does IPC work uses its own instance.
+ */
+class ReportProfiler
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Enable or disable timing
+    void SetEnabled(bool enabled)
+    {
+        m_enabled = enabled;
+    }
+
+    /// @return Whether timing is enabled
+    bool IsEnabled() const
+    {
+        return m_enabled;
+    }
+
+    /// Start timing a report
+    void BeginReport()
+    {
+        if (m_enabled)
+        {
+            m_current.fill(0.0);
+            m_reportStart = Clock::now();
+        }
+    }
+
+    /**
+     * Add time spent in a phase of the current report
+     * @param phase Profiled phase
+     * @param elapsed Wall time spent
+     */
+    void Add(ProfilePhase phase, Clock::duration elapsed)
+    {
+        m_current[phase] += std::chrono::duration<double, std::micro>(elapsed).count();
+    }
+
+    /// Finish timing the current report and store its samples
+    void EndReport()
+    {
+        if (!m_enabled)
+        {
+            return;
+        }
+        double total =
+            std::chrono::duration<double, std::micro>(Clock::now() - m_reportStart).count();
+        double other = total;
+        for (uint8_t p = 0; p < PROFILE_PHASE_COUNT; ++p)
+        {
+            m_samples[p].push_back(m_current[p]);
+            other -= m_current[p];
+        }
+        m_other.push_back(std::max(other, 0.0));
+        m_total.push_back(total);
+    }
+
+    /// @return Number of profiled reports
+    std::size_t GetReportCount() const
+    {
+        return m_total.size();
+    }
+
+    /// @return Sum of the total wall time of all reports (seconds)
+    double GetTotalSeconds() const
+    {
+        double sum = 0.0;
+        for (double us : m_total)
+        {
+            sum += us;
+        }
+        return sum / 1e6;
+    }
+
+    /**
+     * Percentile of the per-report time of a phase
+     * @param phase Profiled phase, PROFILE_PHASE_COUNT for the unattributed rest,
+     *              PROFILE_PHASE_COUNT + 1 for the whole report
+     * @param q Quantile in [0, 1]
+     * @return Wall time in microseconds (0 without samples)
+     */
+    double Percentile(uint8_t phase, double q) const
+    {
+        return Quantile((phase < PROFILE_PHASE_COUNT)    ? m_samples[phase]
+                        : (phase == PROFILE_PHASE_COUNT) ? m_other
+                                                         : m_total,
+                        q);
+    }
+
+    /**
+     * Percentile of the per-report IPC round trip (ipc_send + ipc_wait)
+     * @param q Quantile in [0, 1]
+     * @return Wall time in microseconds (0 without samples)
+     */
+    double RoundTripPercentile(double q) const
+    {
+        std::vector<double> roundTrips(m_samples[PROFILE_IPC_SEND]);
+        for (std::size_t i = 0; i < roundTrips.size(); ++i)
+        {
+            roundTrips[i] += m_samples[PROFILE_IPC_WAIT][i];
+        }
+        return Quantile(std::move(roundTrips), q);
+    }
+
+    /**
+     * Print per-phase percentiles and a log2 histogram of the report time
+     * @param os Output stream
+     * @param title Summary title
+     */
+    void Print(std::ostream &os, const std::string &title) const
+    {
+        static const char *names[PROFILE_PHASE_COUNT + 2] =
+            {"stats", "ipc_send", "ipc_wait", "tx_update", "other", "report"};
+
+        os << "=== " << title << ": " << GetReportCount() << " reports ===\n";
+        os << std::left << std::setw(10) << "phase" << std::right << std::setw(12) << "p50_us"
+           << std::setw(12) << "p95_us" << std::setw(12) << "p99_us" << "\n";
+        for (uint8_t p = 0; p <= PROFILE_PHASE_COUNT + 1; ++p)
+        {
+            os << std::left << std::setw(10) << names[p] << std::right << std::fixed
+               << std::setprecision(1) << std::setw(12) << Percentile(p, 0.50) << std::setw(12)
+               << Percentile(p, 0.95) << std::setw(12) << Percentile(p, 0.99) << "\n";
+        }
+
+        // Histogram of the total report time in power-of-two microsecond buckets
+        std::array<std::size_t, 32> buckets{};
+        for (double us : m_total)
+        {
+            std::size_t b = 0;
+            while (b + 1 < buckets.size() && us >= static_cast<double>(1ULL << (b + 1)))
+            {
+                ++b;
+            }
+            ++buckets[b];
+        }
+        std::size_t maxCount =
+            std::max<std::size_t>(1, *std::max_element(buckets.begin(), buckets.end()));
+        for (std::size_t b = 0; b < buckets.size(); ++b)
+        {
+            if (buckets[b] == 0)
+            {
+                continue;
+            }
+            os << "  [" << std::setw(9) << (b == 0 ? 0ULL : 1ULL << b) << ", " << std::setw(9)
+               << (1ULL << (b + 1)) << ") us " << std::setw(7) << buckets[b] << " "
+               << std::string(1 + 49 * buckets[b] / maxCount, '#') << "\n";
+        }
+        os.unsetf(std::ios::fixed);
+    }
+
+  private:
+    /// @return Quantile q of samples (0 when empty)
+    static double Quantile(std::vector<double> samples, double q)
+    {
+        if (samples.empty())
+        {
+            return 0.0;
+        }
+        std::size_t k = std::min(samples.size() - 1, static_cast<std::size_t>(q * samples.size()));
+        std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+        return samples[k];
+    }
+
+    bool m_enabled = false;                              ///< Timing enabled
+    Clock::time_point m_reportStart;                     ///< Start of the current report
+    std::array<double, PROFILE_PHASE_COUNT> m_current{}; ///< Current report (us per phase)
+    std::array<std::vector<double>, PROFILE_PHASE_COUNT> m_samples; ///< Per-report samples (us)
+    std::vector<double> m_other;                         ///< Per-report unattributed time (us)
+    std::vector<double> m_total;                         ///< Per-report total time (us)
+};
+
+/**
+ * @class ProfileScope
+ * @brief Adds the wall time of a scope to one phase of a ReportProfiler
+ */
+class ProfileScope
+{
+  public:
+    /**
+     * @param profiler Profiler to charge (may be null)
+     * @param phase Phase the scope belongs to
+     */
+    ProfileScope(ReportProfiler *profiler, ProfilePhase phase)
+        : m_profiler(profiler && profiler->IsEnabled() ? profiler : nullptr),
+          m_phase(phase)
+    {
+        if (m_profiler)
+        {
+            m_start = ReportProfiler::Clock::now();
+        }
+    }
+
+    ~ProfileScope()
+    {
+        Stop();
+    }
+
+    /// Charge the time so far and stop timing (the destructor then does nothing)
+    void Stop()
+    {
+        if (m_profiler)
+        {
+            m_profiler->Add(m_phase, ReportProfiler::Clock::now() - m_start);
+            m_profiler = nullptr;
+        }
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+  private:
+    ReportProfiler *m_profiler;                ///< Profiler charged, null when disabled
+    ProfilePhase m_phase;                      ///< Phase charged
+    ReportProfiler::Clock::time_point m_start; ///< Scope entry time
+};
+
+#endif // WIFI_PROFILER_H
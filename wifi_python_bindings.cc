@@ -28,67 +28,171 @@
  *
  * Key components:
  * - EnvStruct binding for receiving WiFi network data from C++
- * - ActStruct binding for sending control commands to C++
- * - Message interface for synchronized data exchange
+ * - ActStruct and ActBatchStruct bindings for sending control commands to C++
+ * - EnvBatchStruct binding for receiving a whole report in one round trip
+ * - CompactBatchStruct binding for the compact, versioned report layout
+ * - Shared-memory vector bindings for vector-mode (multi-record) exchange
+ * - NumPy structured-array views over the shared-memory records (no copy)
+ * - Message interfaces for synchronized data exchange
+ * - ShmRing: reader of the lock-free telemetry ring and writer of the action ring
  */
 
-// Include the WiFi simulation data structures
+// Include the WiFi simulation data structures and the shared-memory rings
 #include "wifi_data_structures.h"
+#include "wifi_shm_ring.h"
 
 // Include NS3 AI module for message interface functionality
 #include <ns3/ai-module.h>
 
 // Standard library and pybind11 includes
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <thread>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
 // Create namespace alias for cleaner code
 namespace py = pybind11;
 
+// NumPy dtype of EnvStruct, field names as in PyEnvStruct and the toy_data.csv header
+PYBIND11_NUMPY_DTYPE_EX(EnvStruct,
+                        env_pos_x,
+                        "pos_x",
+                        env_pos_y,
+                        "pos_y",
+                        env_distance,
+                        "distance",
+                        env_dl_tp,
+                        "dl_tp",
+                        env_ul_tp,
+                        "ul_tp",
+                        env_get_ApTx,
+                        "get_ApTx",
+                        env_sta_id,
+                        "sta_id",
+                        env_ap_id,
+                        "ap_id",
+                        env_now_sec,
+                        "now_sec",
+                        env_dl_delay,
+                        "dl_delay",
+                        env_dl_jitter,
+                        "dl_jitter",
+                        env_dl_loss,
+                        "dl_loss",
+                        env_ul_delay,
+                        "ul_delay",
+                        env_ul_jitter,
+                        "ul_jitter",
+                        env_ul_loss,
+                        "ul_loss",
+                        env_rx_frames,
+                        "rx_frames",
+                        env_rx_drops,
+                        "rx_drops",
+                        env_tx_drops,
+                        "tx_drops",
+                        env_ap_rx_drops,
+                        "ap_rx_drops",
+                        env_rssi,
+                        "rssi",
+                        env_snr,
+                        "snr");
+
+// NumPy dtypes of the compact report records (field names as in ENV_DTYPE where shared)
+PYBIND11_NUMPY_DTYPE(CompactApRecord, pos_x, pos_y, tx_power, ul_tp, rx_drops);
+PYBIND11_NUMPY_DTYPE(CompactStaRecord,
+                     pos_x,
+                     pos_y,
+                     dl_tp,
+                     dl_delay,
+                     dl_jitter,
+                     dl_loss,
+                     ul_delay,
+                     ul_jitter,
+                     ul_loss,
+                     rssi,
+                     snr,
+                     rx_frames,
+                     rx_drops,
+                     tx_drops,
+                     sta_id,
+                     ap_id);
+
 /**
- * PYBIND11_MODULE: Creates a Python module named 'ns3ai_wifi_py'
- * This module will be compiled into a .so file that Python can import
+ * One-dimensional NumPy view of n contiguous values in shared memory
+ * The view does not copy: it stays valid while base (the Python object owning
+ * or referencing the memory) is alive and reflects later writes by either side.
+ * Copy it (e.g. view.copy() or view.tolist()) before PyRecvEnd if the values
+ * are needed after the round trip.
  *
- * @param ns3ai_wifi_py: Name of the Python module (matches CMakeLists.txt)
- * @param m: Module object variable name used in the binding definitions
+ * @param data: First value
+ * @param n: Number of values
+ * @param base: Python object the view keeps alive
  */
-PYBIND11_MODULE(ns3ai_wifi_py, m)
+template <typename T>
+py::array_t<T>
+SharedArrayView(T *data, std::size_t n, py::handle base)
 {
-    /**
-     * Bind the EnvStruct C++ class to Python as "PyEnvStruct"
-     * This structure contains WiFi network data sent FROM C++ TO Python
-     * - Position coordinates (pos_x, pos_y)
-     * - Network performance metrics (dl_tp, ul_tp)
-     * - AP transmission parameters (get_ApTx)
-     * - Timing and identification data (now_sec, sta_id)
-     */
-    py::class_<EnvStruct>(m, "PyEnvStruct")
-        .def(py::init<>())                                   // Default constructor
-        .def_readwrite("pos_x", &EnvStruct::env_pos_x)       // STA X position in meters
-        .def_readwrite("pos_y", &EnvStruct::env_pos_y)       // STA Y position in meters
-        .def_readwrite("distance", &EnvStruct::env_distance) // Distance to AP in meters
-        .def_readwrite("dl_tp", &EnvStruct::env_dl_tp)       // Downlink throughput (Mbps)
-        .def_readwrite("ul_tp", &EnvStruct::env_ul_tp)       // Uplink throughput (Mbps)
-        .def_readwrite("get_ApTx", &EnvStruct::env_get_ApTx) // Current AP Tx power/MCS
-        .def_readwrite("sta_id", &EnvStruct::env_sta_id)     // Station identifier
-        .def_readwrite("now_sec", &EnvStruct::env_now_sec);  // Current simulation time
+    return py::array_t<T>({static_cast<py::ssize_t>(n)},
+                          {static_cast<py::ssize_t>(sizeof(T))},
+                          data,
+                          base);
+}
 
-    /**
-     * Bind the ActStruct C++ class to Python as "PyActStruct"
-     * This structure contains control commands sent FROM Python TO C++
-     * - AP transmission parameter adjustments (set_ApTx)
-     * - Used for adaptive algorithms and power control
-     */
-    py::class_<ActStruct>(m, "PyActStruct")
-        .def(py::init<>())                                    // Default constructor
-        .def_readwrite("set_ApTx", &ActStruct::env_set_ApTx); // New AP Tx power/MCS
+// Vector-mode containers live in shared memory: bind them as opaque types (no list conversion)
+using WifiMsgInterface = ns3::Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct>;
+PYBIND11_MAKE_OPAQUE(WifiMsgInterface::Cpp2PyMsgVector);
+PYBIND11_MAKE_OPAQUE(WifiMsgInterface::Py2CppMsgVector);
 
-    /**
-     * Bind the NS3 AI Message Interface to Python
-     * This is the core communication interface for WiFi simulation data exchange
-     * Template parameters: <EnvStruct, ActStruct> specify the data structures used
-     */
-    py::class_<ns3::Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct>>(m, "Ns3AiMsgInterfaceImpl")
+/**
+ * Bind a shared-memory message vector to Python
+ * - resize(n): set the number of records (done by the memory creator)
+ * - len(vec) / vec[i]: element access by reference into shared memory (no copy)
+ *
+ * @param m: Module object the vector class is added to
+ * @param name: Python class name of the vector
+ */
+template <typename VectorType>
+py::class_<VectorType>
+BindMsgVector(py::module_ &m, const char *name)
+{
+    using ValueType = typename VectorType::value_type;
+
+    return py::class_<VectorType>(m, name)
+        .def("resize",
+             static_cast<void (VectorType::*)(typename VectorType::size_type)>(
+                 &VectorType::resize))
+        .def("__len__", &VectorType::size)
+        .def(
+            "__getitem__",
+            [](VectorType &vec, std::size_t i) -> ValueType & {
+                if (i >= vec.size())
+                {
+                    throw py::index_error("Shared message vector index out of range");
+                }
+                return vec[i];
+            },
+            py::return_value_policy::reference_internal);
+}
+
+/**
+ * Bind an NS3 AI Message Interface instantiation to Python
+ * This is the core communication interface for WiFi simulation data exchange
+ * Template parameters: <Cpp2PyMsgType, Py2CppMsgType> specify the data structures used
+ *
+ * @param m: Module object the interface class is added to
+ * @param name: Python class name of the interface
+ */
+template <typename Cpp2PyMsgType, typename Py2CppMsgType>
+py::class_<ns3::Ns3AiMsgInterfaceImpl<Cpp2PyMsgType, Py2CppMsgType>>
+BindMsgInterface(py::module_ &m, const char *name)
+{
+    using MsgInterface = ns3::Ns3AiMsgInterfaceImpl<Cpp2PyMsgType, Py2CppMsgType>;
+
+    return py::class_<MsgInterface>(m, name)
         /**
          * Constructor binding with all parameters for shared memory communication:
          * @param bool: useVector - whether to use vector-based communication
@@ -116,52 +220,496 @@ PYBIND11_MODULE(ns3ai_wifi_py, m)
         /**
          * PyRecvBegin: Start receiving WiFi data from C++ simulation
          * Call this before reading network performance data
-         * Returns: Pointer to EnvStruct containing current WiFi network state
+         * Returns: Pointer to the C++ → Python struct containing current WiFi network state
          */
-        .def("PyRecvBegin", &ns3::Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct>::PyRecvBegin)
+        .def("PyRecvBegin", &MsgInterface::PyRecvBegin)
 
         /**
          * PyRecvEnd: End receiving WiFi data from C++ simulation
          * Call this after finishing reading from shared memory
          * Signals to C++ that Python has finished processing current data
          */
-        .def("PyRecvEnd", &ns3::Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct>::PyRecvEnd)
+        .def("PyRecvEnd", &MsgInterface::PyRecvEnd)
 
         /**
          * PySendBegin: Start sending control commands to C++ simulation
          * Call this before writing adaptive control parameters
-         * Returns: Pointer to ActStruct for writing Python control decisions
+         * Returns: Pointer to the Python → C++ struct for writing control decisions
          */
-        .def("PySendBegin", &ns3::Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct>::PySendBegin)
+        .def("PySendBegin", &MsgInterface::PySendBegin)
 
         /**
          * PySendEnd: End sending control commands to C++ simulation
          * Call this after finishing writing control parameters
          * Signals to C++ that new control data is ready for application
          */
-        .def("PySendEnd", &ns3::Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct>::PySendEnd)
+        .def("PySendEnd", &MsgInterface::PySendEnd)
 
         /**
          * PyGetFinished: Check if WiFi simulation has finished
          * Returns: bool indicating whether C++ simulation is complete
          */
-        .def("PyGetFinished", &ns3::Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct>::PyGetFinished)
+        .def("PyGetFinished", &MsgInterface::PyGetFinished)
 
         /**
          * GetCpp2PyStruct: Get direct access to WiFi simulation data
-         * Returns: Reference to EnvStruct (WiFi data from C++ to Python)
+         * Returns: Reference to the C++ → Python struct (WiFi data from C++ to Python)
          * return_value_policy::reference: Return by reference (no copy)
          */
         .def("GetCpp2PyStruct",
-             &ns3::Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct>::GetCpp2PyStruct,
+             &MsgInterface::GetCpp2PyStruct,
              py::return_value_policy::reference)
 
         /**
          * GetPy2CppStruct: Get direct access to control command structure
-         * Returns: Reference to ActStruct (control commands from Python to C++)
+         * Returns: Reference to the Python → C++ struct (control commands to C++)
          * return_value_policy::reference: Return by reference (no copy)
          */
         .def("GetPy2CppStruct",
-             &ns3::Ns3AiMsgInterfaceImpl<EnvStruct, ActStruct>::GetPy2CppStruct,
+             &MsgInterface::GetPy2CppStruct,
              py::return_value_policy::reference);
 }
+
+/**
+ * @class RingPeer
+ * @brief Python side of a ring segment: one telemetry reader cursor and the action writer
+ */
+class RingPeer
+{
+  public:
+    /**
+     * Open the segment created by the simulation and take a telemetry cursor
+     * @param name: POSIX shared-memory name ("/<shmPrefix>WifiRing")
+     * @param reader: Cursor index, 0 for the controller, 1.. for observers
+     * @param timeout: Seconds to wait for the simulation to create the segment
+     */
+    RingPeer(const std::string &name, uint32_t reader, double timeout)
+        : m_reader(reader)
+    {
+        if (reader >= WIFI_RING_MAX_READERS)
+        {
+            throw py::value_error("ShmRing reader index out of range");
+        }
+        {
+            py::gil_scoped_release release;
+            auto deadline =
+                std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+            while (!m_segment.Open(name) && std::chrono::steady_clock::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        if (!m_segment.IsOpen())
+        {
+            throw std::runtime_error("Cannot open shared-memory ring " + name);
+        }
+        if (m_segment.Telemetry().GetRecordSize() != sizeof(EnvStruct) ||
+            m_segment.Actions().GetRecordSize() != sizeof(ActBatchStruct))
+        {
+            throw std::runtime_error("Shared-memory ring " + name + " has other record sizes");
+        }
+        m_segment.Telemetry().AttachReader(m_reader);
+    }
+
+    ~RingPeer()
+    {
+        Detach();
+    }
+
+    /**
+     * Wait for ready telemetry records
+     * @param maxRecords: Most records returned (0: no limit)
+     * @param timeout: Seconds to wait if none is ready (0: do not wait)
+     * @return Ready records, contiguous in the ring (an empty span if none)
+     */
+    RingSpan Poll(uint32_t maxRecords, double timeout)
+    {
+        CheckOpen();
+        ShmRing &telemetry = m_segment.Telemetry();
+        m_span = telemetry.Poll(m_reader, maxRecords);
+        if (m_span.count == 0 && timeout > 0.0 && !telemetry.IsClosed())
+        {
+            py::gil_scoped_release release;
+            auto deadline =
+                std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+            while (m_span.count == 0 && !telemetry.IsClosed() &&
+                   std::chrono::steady_clock::now() < deadline)
+            {
+                std::this_thread::yield();
+                m_span = telemetry.Poll(m_reader, maxRecords);
+            }
+        }
+        m_skipped += m_span.skipped;
+        return m_span;
+    }
+
+    /// @return false if the records of the last poll may have been overwritten while in use
+    bool Release()
+    {
+        CheckOpen();
+        bool intact = m_segment.Telemetry().Release(m_reader, m_span);
+        m_span = RingSpan{m_span.start + m_span.count, 0, 0};
+        return intact;
+    }
+
+    /**
+     * Copy an action into the action ring, waiting while it is full
+     * @param action: Action to send
+     * @return false if the simulation has shut the ring down
+     */
+    bool WriteAction(const ActBatchStruct &action)
+    {
+        CheckOpen();
+        ShmRing &actions = m_segment.Actions();
+        uint64_t position = 0;
+        bool reserved = false;
+        {
+            py::gil_scoped_release release;
+            reserved = actions.Reserve(1, position);
+        }
+        if (!reserved)
+        {
+            return false;
+        }
+        std::memcpy(actions.Slot(position), &action, sizeof(ActBatchStruct));
+        actions.Publish();
+        return true;
+    }
+
+    /// Give up the telemetry cursor (the simulation no longer waits for a controller)
+    void Detach()
+    {
+        if (m_segment.IsOpen())
+        {
+            m_segment.Telemetry().DetachReader(m_reader);
+            m_segment.Close();
+        }
+    }
+
+    /// @return First record of the last poll
+    EnvStruct *SpanData()
+    {
+        return static_cast<EnvStruct *>(m_segment.Telemetry().Slot(m_span.start));
+    }
+
+    /// @return true once the simulation has ended and every record has been read
+    bool IsClosed()
+    {
+        return !m_segment.IsOpen() || (m_segment.Telemetry().IsClosed() &&
+                                       m_segment.Telemetry().GetPending(m_reader) == 0);
+    }
+
+    /// Throw if the ring has been detached (its memory is no longer mapped)
+    void CheckOpen() const
+    {
+        if (!m_segment.IsOpen())
+        {
+            throw std::runtime_error("ShmRing has been detached");
+        }
+    }
+
+    ShmRingSegment m_segment; ///< Mapping of the simulation's rings
+    uint32_t m_reader;        ///< Telemetry cursor index
+    RingSpan m_span;          ///< Records of the last poll (released by Release())
+    uint64_t m_skipped = 0;   ///< Records this observer lost because it fell a ring behind
+};
+
+/**
+ * PYBIND11_MODULE: Creates a Python module named 'ns3ai_wifi_py'
+ * This module will be compiled into a .so file that Python can import
+ *
+ * @param ns3ai_wifi_py: Name of the Python module (matches CMakeLists.txt)
+ * @param m: Module object variable name used in the binding definitions
+ */
+PYBIND11_MODULE(ns3ai_wifi_py, m)
+{
+    // Structure sizes, so Python can size the shared memory segment it creates
+    m.attr("ENV_STRUCT_SIZE") = sizeof(EnvStruct);
+    m.attr("BATCH_STRUCT_SIZE") = sizeof(EnvBatchStruct);
+    m.attr("COMPACT_STRUCT_SIZE") = sizeof(CompactBatchStruct);
+    m.attr("COMPACT_VERSION") = WIFI_COMPACT_VERSION;
+    m.attr("COMPACT_AP_DTYPE") = py::dtype::of<CompactApRecord>();
+    m.attr("COMPACT_STA_DTYPE") = py::dtype::of<CompactStaRecord>();
+    m.attr("ACT_STRUCT_SIZE") = sizeof(ActStruct);
+    m.attr("ACT_BATCH_STRUCT_SIZE") = sizeof(ActBatchStruct);
+    m.attr("MAX_APS") = WIFI_MAX_APS;
+    m.attr("MCS_KEEP") = WIFI_MCS_KEEP;
+    m.attr("ENV_DTYPE") = py::dtype::of<EnvStruct>();
+
+    /**
+     * Bind the EnvStruct C++ class to Python as "PyEnvStruct"
+     * This structure contains WiFi network data sent FROM C++ TO Python
+     * - Position coordinates (pos_x, pos_y)
+     * - Network performance metrics (dl_tp, ul_tp)
+     * - AP transmission parameters (get_ApTx)
+     * - Timing and identification data (now_sec, sta_id)
+     * - as_array(): the record as a NumPy structured array of dtype ENV_DTYPE
+     */
+    py::class_<EnvStruct>(m, "PyEnvStruct")
+        .def(py::init<>())                                         // Default constructor
+        .def_readwrite("pos_x", &EnvStruct::env_pos_x)             // STA X position in meters
+        .def_readwrite("pos_y", &EnvStruct::env_pos_y)             // STA Y position in meters
+        .def_readwrite("distance", &EnvStruct::env_distance)       // Distance to AP in meters
+        .def_readwrite("dl_tp", &EnvStruct::env_dl_tp)             // Downlink throughput (Mbps)
+        .def_readwrite("ul_tp", &EnvStruct::env_ul_tp)             // Uplink throughput (Mbps)
+        .def_readwrite("get_ApTx", &EnvStruct::env_get_ApTx)       // Current AP Tx power/MCS
+        .def_readwrite("sta_id", &EnvStruct::env_sta_id)           // Station identifier
+        .def_readwrite("ap_id", &EnvStruct::env_ap_id)             // Serving AP (BSS) index
+        .def_readwrite("now_sec", &EnvStruct::env_now_sec)         // Current simulation time
+        .def_readwrite("dl_delay", &EnvStruct::env_dl_delay)       // Mean DL delay (ms)
+        .def_readwrite("dl_jitter", &EnvStruct::env_dl_jitter)     // Mean DL jitter (ms)
+        .def_readwrite("dl_loss", &EnvStruct::env_dl_loss)         // DL loss fraction
+        .def_readwrite("ul_delay", &EnvStruct::env_ul_delay)       // Mean UL delay (ms)
+        .def_readwrite("ul_jitter", &EnvStruct::env_ul_jitter)     // Mean UL jitter (ms)
+        .def_readwrite("ul_loss", &EnvStruct::env_ul_loss)         // UL loss fraction
+        .def_readwrite("rx_frames", &EnvStruct::env_rx_frames)     // Frames decoded by the STA
+        .def_readwrite("rx_drops", &EnvStruct::env_rx_drops)       // STA PHY RX drops
+        .def_readwrite("tx_drops", &EnvStruct::env_tx_drops)       // STA PHY TX drops
+        .def_readwrite("ap_rx_drops", &EnvStruct::env_ap_rx_drops) // Serving AP PHY RX drops
+        .def_readwrite("rssi", &EnvStruct::env_rssi)               // Mean RSSI (dBm)
+        .def_readwrite("snr", &EnvStruct::env_snr)                 // Mean SNR (dB)
+        // One-record ENV_DTYPE view (no copy)
+        .def("as_array", [](py::object self) {
+            return SharedArrayView(&self.cast<EnvStruct &>(), 1, self);
+        });
+
+    /**
+     * Bind the ActStruct C++ class to Python as "PyActStruct"
+     * This structure contains control commands sent FROM Python TO C++
+     * (per-STA and vector modes)
+     * - AP transmission parameter adjustments (set_ApTx, applied to every AP)
+     * - Per-AP adjustments: act.count = n, then act[k] = Tx power of AP k
+     * - Used for adaptive algorithms and power control
+     */
+    py::class_<ActStruct>(m, "PyActStruct")
+        .def(py::init<>())                                   // Default constructor
+        .def_readwrite("set_ApTx", &ActStruct::env_set_ApTx) // New AP Tx power/MCS
+        .def_readwrite("count", &ActStruct::act_count)       // Number of per-AP entries (0: all)
+        .def_property_readonly_static(                       // Fixed per-AP capacity
+            "capacity",
+            [](py::object) { return WIFI_MAX_APS; })
+        .def("__getitem__",
+             [](const ActStruct &act, uint32_t k) {
+                 if (k >= WIFI_MAX_APS)
+                 {
+                     throw py::index_error("ActStruct AP index out of range");
+                 }
+                 return act.act_set_ApTx[k];
+             })
+        .def("__setitem__",
+             [](ActStruct &act, uint32_t k, double txPower) {
+                 if (k >= WIFI_MAX_APS)
+                 {
+                     throw py::index_error("ActStruct AP index out of range");
+                 }
+                 act.act_set_ApTx[k] = txPower;
+             })
+        // Writable NumPy view of the per-AP array (full capacity, no copy)
+        .def_property_readonly("ap_tx", [](py::object self) {
+            ActStruct &act = self.cast<ActStruct &>();
+            return SharedArrayView(act.act_set_ApTx, WIFI_MAX_APS, self);
+        });
+
+    /**
+     * Bind the ActBatchStruct C++ class to Python as "PyActBatchStruct"
+     * The PyActStruct commands plus per-STA actions (batch, async and ring modes)
+     * - Per-STA adjustments: act.sta_count = n, then act.set_sta_mcs(i, mcs)
+     *   (MCS_KEEP: unchanged) and act.set_sta_tx_power(i, dBm) (NaN: unchanged)
+     */
+    py::class_<ActBatchStruct, ActStruct>(m, "PyActBatchStruct")
+        .def(py::init<>())                                          // Default constructor
+        .def_readwrite("sta_count", &ActBatchStruct::act_sta_count) // Number of per-STA entries
+        .def_property_readonly_static(                              // Fixed per-STA capacity
+            "sta_capacity",
+            [](py::object) { return WIFI_MAX_BATCH_STAS; })
+        .def("get_sta_mcs",
+             [](const ActBatchStruct &act, uint32_t i) {
+                 if (i >= WIFI_MAX_BATCH_STAS)
+                 {
+                     throw py::index_error("ActBatchStruct STA index out of range");
+                 }
+                 return act.act_sta_mcs[i];
+             })
+        .def("set_sta_mcs",
+             [](ActBatchStruct &act, uint32_t i, uint8_t mcs) {
+                 if (i >= WIFI_MAX_BATCH_STAS)
+                 {
+                     throw py::index_error("ActBatchStruct STA index out of range");
+                 }
+                 act.act_sta_mcs[i] = mcs;
+             })
+        .def("get_sta_tx_power",
+             [](const ActBatchStruct &act, uint32_t i) {
+                 if (i >= WIFI_MAX_BATCH_STAS)
+                 {
+                     throw py::index_error("ActBatchStruct STA index out of range");
+                 }
+                 return act.act_sta_txPower[i];
+             })
+        .def("set_sta_tx_power",
+             [](ActBatchStruct &act, uint32_t i, double txPower) {
+                 if (i >= WIFI_MAX_BATCH_STAS)
+                 {
+                     throw py::index_error("ActBatchStruct STA index out of range");
+                 }
+                 act.act_sta_txPower[i] = txPower;
+             })
+        // Writable NumPy views of the per-STA arrays (full capacity, no copy)
+        .def_property_readonly("sta_mcs",
+                               [](py::object self) {
+                                   ActBatchStruct &act = self.cast<ActBatchStruct &>();
+                                   return SharedArrayView(act.act_sta_mcs,
+                                                          WIFI_MAX_BATCH_STAS,
+                                                          self);
+                               })
+        .def_property_readonly("sta_tx_power", [](py::object self) {
+            ActBatchStruct &act = self.cast<ActBatchStruct &>();
+            return SharedArrayView(act.act_sta_txPower, WIFI_MAX_BATCH_STAS, self);
+        });
+
+    /**
+     * Bind the EnvBatchStruct C++ class to Python as "PyEnvBatchStruct"
+     * This structure carries every STA record of one report FROM C++ TO Python
+     * - count: number of valid records in the batch
+     * - batch[i]: EnvStruct view into shared memory (no copy)
+     * - batch.as_array(): NumPy view of the count valid records (no copy)
+     * py::return_value_policy::reference_internal keeps the batch alive while
+     * a record view is in use
+     */
+    py::class_<EnvBatchStruct>(m, "PyEnvBatchStruct")
+        .def(py::init<>())                                  // Default constructor
+        .def_readwrite("count", &EnvBatchStruct::env_count) // Number of valid records
+        .def_property_readonly_static(                      // Fixed record capacity
+            "capacity",
+            [](py::object) { return WIFI_MAX_BATCH_STAS; })
+        .def("__len__", [](const EnvBatchStruct &batch) { return batch.env_count; })
+        .def(
+            "__getitem__",
+            [](EnvBatchStruct &batch, uint32_t i) -> EnvStruct & {
+                if (i >= batch.env_count)
+                {
+                    throw py::index_error("EnvBatchStruct record index out of range");
+                }
+                return batch.env_records[i];
+            },
+            py::return_value_policy::reference_internal)
+        // ENV_DTYPE view of the valid records (no copy)
+        .def("as_array", [](py::object self) {
+            EnvBatchStruct &batch = self.cast<EnvBatchStruct &>();
+            return SharedArrayView(batch.env_records, batch.env_count, self);
+        });
+
+    /**
+     * Bind the CompactBatchStruct C++ class to Python as "PyCompactBatchStruct"
+     * The same report as PyEnvBatchStruct in the compact layout (wireFormat=compact)
+     * - version, ap_record_size, sta_record_size: layout tags written by C++, to be
+     *   checked against COMPACT_VERSION and the item sizes of the compact dtypes
+     * - now_sec: simulation time of the report
+     * - aps_array(): COMPACT_AP_DTYPE view of the ap_count per-AP records (no copy)
+     * - stas_array(): COMPACT_STA_DTYPE view of the sta_count per-STA records (no copy)
+     */
+    py::class_<CompactBatchStruct>(m, "PyCompactBatchStruct")
+        .def(py::init<>())
+        .def_property_readonly("version",
+                               [](const CompactBatchStruct &b) { return b.header.version; })
+        .def_property_readonly("ap_record_size",
+                               [](const CompactBatchStruct &b) { return b.header.ap_record_size; })
+        .def_property_readonly("sta_record_size",
+                               [](const CompactBatchStruct &b) {
+                                   return b.header.sta_record_size;
+                               })
+        .def_property_readonly("ap_count",
+                               [](const CompactBatchStruct &b) { return b.header.ap_count; })
+        .def_property_readonly("sta_count",
+                               [](const CompactBatchStruct &b) { return b.header.sta_count; })
+        .def_property_readonly("now_sec",
+                               [](const CompactBatchStruct &b) { return b.header.now_sec; })
+        .def("aps_array",
+             [](py::object self) {
+                 CompactBatchStruct &batch = self.cast<CompactBatchStruct &>();
+                 return SharedArrayView(batch.aps,
+                                        std::min<uint32_t>(batch.header.ap_count, WIFI_MAX_APS),
+                                        self);
+             })
+        .def("stas_array", [](py::object self) {
+            CompactBatchStruct &batch = self.cast<CompactBatchStruct &>();
+            return SharedArrayView(batch.stas,
+                                   std::min(batch.header.sta_count, WIFI_MAX_BATCH_STAS),
+                                   self);
+        });
+
+    /**
+     * Bind the vector-mode containers:
+     * - PyEnvVector: EnvStruct records of several reports FROM C++ TO Python
+     * - PyActVector: ActStruct control commands FROM Python TO C++
+     */
+    BindMsgVector<WifiMsgInterface::Cpp2PyMsgVector>(m, "PyEnvVector")
+        // Structured-array view of every slot (ENV_DTYPE, no copy)
+        .def("as_array", [](py::object self) {
+            auto &vec = self.cast<WifiMsgInterface::Cpp2PyMsgVector &>();
+            return SharedArrayView(vec.data(), vec.size(), self);
+        });
+    BindMsgVector<WifiMsgInterface::Py2CppMsgVector>(m, "PyActVector");
+
+    // Per-STA message interface: one EnvStruct per round trip, or a vector of them
+    BindMsgInterface<EnvStruct, ActStruct>(m, "Ns3AiMsgInterfaceImpl")
+        /**
+         * GetCpp2PyVector: Get direct access to the vector of WiFi records (vector mode)
+         * Returns: Reference to PyEnvVector in shared memory (no copy)
+         */
+        .def("GetCpp2PyVector",
+             &WifiMsgInterface::GetCpp2PyVector,
+             py::return_value_policy::reference)
+
+        /**
+         * GetPy2CppVector: Get direct access to the vector of control commands (vector mode)
+         * Returns: Reference to PyActVector in shared memory (no copy)
+         */
+        .def("GetPy2CppVector",
+             &WifiMsgInterface::GetPy2CppVector,
+             py::return_value_policy::reference);
+
+    // Batched message interface: one EnvBatchStruct (all STAs) per round trip
+    BindMsgInterface<EnvBatchStruct, ActBatchStruct>(m, "Ns3AiBatchMsgInterfaceImpl");
+
+    // Compact batched message interface: one CompactBatchStruct per round trip
+    BindMsgInterface<CompactBatchStruct, ActBatchStruct>(m, "Ns3AiCompactMsgInterfaceImpl");
+
+    /**
+     * Bind RingPeer to Python as "ShmRing" (ipcMode=ring, no ns3-ai handshake)
+     * - ShmRing(name, reader=0, timeout=10.0): open the simulation's rings;
+     *   reader 0 is the controller (the simulation waits for it when it is a
+     *   whole ring behind), readers 1.. are observers such as a dashboard
+     * - ring.poll(max_records=0, timeout=0.0): ENV_DTYPE view of the ready
+     *   records in shared memory (no copy, possibly fewer than all ready ones
+     *   at the end of the ring); read or copy it before release()
+     * - ring.release(): hand the polled records back; False if an observer fell
+     *   behind far enough for them to be overwritten while in use
+     * - ring.write_action(act): send a PyActBatchStruct to the simulation, applied
+     *   at its next report
+     * - ring.closed: True once the simulation has ended and every record has been read
+     * - ring.detach(): give up the cursor and unmap the rings (earlier views become invalid)
+     */
+    py::class_<RingPeer>(m, "ShmRing")
+        .def(py::init<const std::string &, uint32_t, double>(),
+             py::arg("name"),
+             py::arg("reader") = 0,
+             py::arg("timeout") = 10.0)
+        .def(
+            "poll",
+            [](py::object self, uint32_t maxRecords, double timeout) {
+                RingPeer &peer = self.cast<RingPeer &>();
+                RingSpan span = peer.Poll(maxRecords, timeout);
+                return SharedArrayView(peer.SpanData(), span.count, self);
+            },
+            py::arg("max_records") = 0,
+            py::arg("timeout") = 0.0)
+        .def("release", &RingPeer::Release)
+        .def("write_action", &RingPeer::WriteAction)
+        .def("detach", &RingPeer::Detach)
+        .def_property_readonly("closed", &RingPeer::IsClosed)
+        .def_property_readonly("skipped", [](const RingPeer &peer) { return peer.m_skipped; })
+        .def_property_readonly("capacity", [](RingPeer &peer) {
+            return peer.m_segment.IsOpen() ? peer.m_segment.Telemetry().GetCapacity() : 0;
+        });
+}
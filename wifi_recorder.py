@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Texas State University
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+# Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+# PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+# Texas State University
+
+"""
+WiFi Network Simulation - Columnar Record Buffer and Record Files
+
+Collects the per-STA records of wifi_analysis_and_control.py in one
+preallocated NumPy structured array (one column per field) instead of a list
+of dicts:
+- Records are copied in per column straight from the binding's NumPy views
+- A full chunk is appended to the output file and the buffer is reused, so
+  memory stays bounded by one chunk and a crash loses at most one chunk of
+  records
+- Run totals for the final summary are updated on every flush, so the output
+  is never read back
+
+The output format follows the file extension:
+- .csv: CSV text (the original toy_data.csv)
+- .parquet: Parquet, one row group per chunk (needs pyarrow)
+- .arrow: Arrow IPC file, one record batch per chunk (needs pyarrow)
+
+read_records() loads any of these, or a telemetry log (.bin), with column
+projection: only the requested columns are parsed or decoded.
+"""
+
+import os
+
+import numpy as np
+import pandas as pd
+
+RECORD_FORMATS = {".csv": "csv", ".parquet": "parquet", ".arrow": "arrow", ".bin": "telemetry"}
+
+
+def record_format(path):
+    """Format name of a record file from its extension (csv for unknown extensions)"""
+    return RECORD_FORMATS.get(os.path.splitext(path)[1].lower(), "csv")
+
+
+class CsvSink:
+    """Appends chunks to a CSV file (truncated and headed on creation)"""
+
+    def __init__(self, path, dtype):
+        self.path = path
+        # Header right away: a run that records nothing leaves no stale rows behind
+        pd.DataFrame(np.zeros(0, dtype=dtype)).to_csv(self.path, index=False)
+
+    def write(self, rows):
+        pd.DataFrame(rows).to_csv(self.path, mode="a", header=False, index=False)
+
+    def close(self):
+        pass
+
+
+class ArrowSink:
+    """Streams chunks to a Parquet file (one row group each) or an Arrow IPC file"""
+
+    def __init__(self, path, dtype, parquet):
+        import pyarrow as pa
+
+        self.pa = pa
+        self.schema = pa.schema([(name, pa.from_numpy_dtype(dtype[name])) for name in dtype.names])
+        if parquet:
+            import pyarrow.parquet as pq
+
+            self.writer = pq.ParquetWriter(path, self.schema)
+        else:
+            self.writer = pa.ipc.new_file(path, self.schema)
+
+    def write(self, rows):
+        self.writer.write_table(
+            self.pa.Table.from_arrays(
+                [self.pa.array(rows[name]) for name in self.schema.names], schema=self.schema
+            )
+        )
+
+    def close(self):
+        # Parquet needs its footer, Arrow IPC its file trailer, before the file is readable
+        self.writer.close()
+
+
+def open_sink(path, dtype):
+    """Record sink for path, chosen by its extension"""
+    fmt = record_format(path)
+    if fmt == "telemetry":
+        raise ValueError(f"{path}: telemetry logs are only written by the simulation")
+    if fmt == "csv":
+        return CsvSink(path, dtype)
+    return ArrowSink(path, dtype, parquet=fmt == "parquet")
+
+
+def read_records(path, columns=None):
+    """
+    Load a record file (CSV, Parquet, Arrow IPC or telemetry log) into a DataFrame
+    columns: names of the columns to load (None: all)
+    """
+    fmt = record_format(path)
+    if fmt == "csv":
+        return pd.read_csv(path, usecols=columns)
+    if fmt == "parquet":
+        import pyarrow.parquet as pq
+
+        return pq.read_table(path, columns=columns).to_pandas()
+    if fmt == "arrow":
+        import pyarrow as pa
+
+        # Memory-mapped: unselected columns are never read from disk
+        with pa.memory_map(path) as source:
+            table = pa.ipc.open_file(source).read_all()
+            return (table.select(columns) if columns else table).to_pandas()
+    from wifi_telemetry_log import read_telemetry_log
+
+    return read_telemetry_log(path, columns)
+
+
+class ColumnarRecorder:
+    """Chunked columnar buffer flushed incrementally to a record file"""
+
+    def __init__(self, path, dtype, chunk_rows=65536):
+        """
+        path: output path, format chosen by its extension (truncated on creation)
+        dtype: NumPy structured dtype of one row (field order = column order)
+        chunk_rows: records buffered before they are appended to the file (at least 1)
+        """
+        if chunk_rows < 1:
+            raise ValueError(f"chunk_rows must be at least 1, not {chunk_rows}")
+        self.path = path
+        self.sink = open_sink(path, np.dtype(dtype))
+        self.chunk = np.zeros(chunk_rows, dtype=dtype)
+        self.fill = 0  # Valid rows in the chunk
+        self.rows = 0  # Rows written to the output file
+        self.dl_sum = 0.0
+        self.ul_sum = 0.0
+        self.time_range = (np.inf, -np.inf)
+        self.distance_range = (np.inf, -np.inf)
+
+    def __len__(self):
+        """Number of records collected so far (written or buffered)"""
+        return self.rows + self.fill
+
+    def append(self, records, **columns):
+        """
+        Append a batch of records
+        records: structured array (e.g. an ENV_DTYPE view); fields missing from
+                 the row dtype are ignored
+        columns: values of the remaining row fields, scalars or one per record
+        """
+        n = len(records)
+        start = 0
+        while start < n:
+            count = min(n - start, len(self.chunk) - self.fill)
+            rows = self.chunk[self.fill : self.fill + count]
+            for name in rows.dtype.names:
+                if name in columns:
+                    value = columns[name]
+                    rows[name] = value[start : start + count] if np.ndim(value) else value
+                elif name in records.dtype.names:
+                    rows[name] = records[name][start : start + count]
+            self.fill += count
+            start += count
+            if self.fill == len(self.chunk):
+                self.flush()
+
+    def flush(self):
+        """Append the buffered records to the output file and empty the buffer"""
+        if self.fill == 0:
+            return
+        rows = self.chunk[: self.fill]
+        self.sink.write(rows)
+        self.dl_sum += float(rows["dl_tp"].sum())
+        self.ul_sum += float(rows["ul_tp"].sum())
+        self.time_range = (
+            min(self.time_range[0], float(rows["now_sec"].min())),
+            max(self.time_range[1], float(rows["now_sec"].max())),
+        )
+        self.distance_range = (
+            min(self.distance_range[0], float(rows["distance"].min())),
+            max(self.distance_range[1], float(rows["distance"].max())),
+        )
+        self.rows += self.fill
+        self.fill = 0
+
+    def close(self):
+        """Flush the buffered records and finish the output file"""
+        self.flush()
+        self.sink.close()
+
+    def summary(self):
+        """Run totals of the flushed records (call flush() or close() first)"""
+        return {
+            "rows": self.rows,
+            "duration": self.time_range[1] - self.time_range[0],
+            "mean_dl": self.dl_sum / self.rows if self.rows else 0.0,
+            "mean_ul": self.ul_sum / self.rows if self.rows else 0.0,
+            "distance_min": self.distance_range[0],
+            "distance_max": self.distance_range[1],
+        }
@@ -0,0 +1,551 @@
+/*
+ * Copyright (c) 2025 Texas State University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+ * PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+ * Texas State University
+ */
+
+/**
+ * @file wifi_shm_ring.h
+ * @brief Lock-free rings of fixed-size records in a POSIX shared-memory segment
+ *
+ * Used by ipcMode=ring instead of the ns3-ai Begin/End handshake:
+ * - One writer per ring reserves slots, fills them in place and publishes the
+ *   whole batch (e.g. every STA record of a report) with a single store
+ * - Positions only grow; slot = position % capacity (a power of two)
+ * - Reader 0 flow-controls the writer: the writer waits while reader 0 is
+ *   attached and a whole ring behind. Readers 1.. are observers (e.g. a
+ *   dashboard) that never slow the writer; if they fall a whole ring behind
+ *   they skip ahead, and Release() tells them if a slot was overwritten while
+ *   they read it
+ * - Every position counter sits on its own cache line, so writer and readers
+ *   never write the same line
+ * - Reader cursors record the process id of their reader: a writer waiting
+ *   for reader 0 gives up once that process has exited without detaching
+ *   (e.g. a killed controller), instead of waiting forever
+ *
+ * ShmRingSegment lays out a telemetry ring (C++ to Python) and an action ring
+ * (Python to C++) in one segment created by the simulation and opened by the
+ * Python bindings. The counters are lock-free std::atomic values, which are
+ * address-free and therefore valid across processes.
+ */
+
+#ifndef WIFI_SHM_RING_H
+#define WIFI_SHM_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// Cache line size assumed for the placement of the ring counters
+constexpr std::size_t WIFI_CACHE_LINE = 64;
+
+/// Cursors per ring: reader 0 flow-controls the writer, the others are observers
+constexpr uint32_t WIFI_RING_MAX_READERS = 4;
+
+/// "WIFIRING" in ASCII (little endian), written last once a segment is laid out
+constexpr uint64_t WIFI_RING_MAGIC = 0x474e495249464957ULL;
+
+/// Layout version of the segment, checked by ShmRingSegment::Open()
+constexpr uint32_t WIFI_RING_VERSION = 2;
+
+/// Time between two liveness checks of reader 0 while the writer waits for it
+constexpr std::chrono::milliseconds WIFI_RING_LIVENESS_PERIOD{100};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<int32_t>::is_always_lock_free,
+              "Shared-memory ring counters must be lock-free");
+
+/**
+ * @struct RingCounter
+ * @brief Position counter on a cache line of its own
+ */
+struct alignas(WIFI_CACHE_LINE) RingCounter
+{
+    std::atomic<uint64_t> position; ///< Slots reserved, published or consumed so far
+    std::atomic<uint32_t> attached; ///< Reader cursors: 1 while a reader uses the cursor
+    std::atomic<int32_t> pid;       ///< Reader cursors: process id of the last reader attached
+};
+
+/**
+ * @struct ShmRingHeader
+ * @brief Control block in front of the slots of one ring
+ */
+struct ShmRingHeader
+{
+    uint32_t recordSize;          ///< Bytes per slot (records are packed back to back)
+    uint32_t capacity;            ///< Number of slots, a power of two
+    std::atomic<uint32_t> closed; ///< Set once the ring is shut down (by either side)
+    RingCounter reserved;         ///< Writer: end of the slots being written
+    RingCounter published;        ///< Writer: end of the readable slots
+    RingCounter tails[WIFI_RING_MAX_READERS]; ///< Next position of each reader
+};
+
+/**
+ * @struct RingSpan
+ * @brief Contiguous run of ready slots handed to a reader
+ */
+struct RingSpan
+{
+    uint64_t start = 0;   ///< Position of the first slot
+    uint32_t count = 0;   ///< Number of slots
+    uint64_t skipped = 0; ///< Observers: records lost because the writer lapped the reader
+};
+
+/**
+ * @class ShmRing
+ * @brief Single-writer ring of fixed-size records at a given address
+ *
+ * Does not own its memory; see ShmRingSegment.
+ */
+class ShmRing
+{
+  public:
+    /**
+     * @param recordSize Bytes per record
+     * @param capacity Number of slots
+     * @return Bytes taken by a ring (header and slots, rounded to cache lines)
+     */
+    static std::size_t GetBytes(uint32_t recordSize, uint32_t capacity)
+    {
+        std::size_t slots = static_cast<std::size_t>(recordSize) * capacity;
+        std::size_t lines = (slots + WIFI_CACHE_LINE - 1) / WIFI_CACHE_LINE;
+        return sizeof(ShmRingHeader) + lines * WIFI_CACHE_LINE;
+    }
+
+    /**
+     * Lay out an empty ring
+     * @param base Cache-line aligned memory of GetBytes() bytes
+     * @param recordSize Bytes per record
+     * @param capacity Number of slots (a power of two)
+     */
+    void Create(void *base, uint32_t recordSize, uint32_t capacity)
+    {
+        m_header = new (base) ShmRingHeader();
+        m_header->recordSize = recordSize;
+        m_header->capacity = capacity;
+        m_slots = static_cast<char *>(base) + sizeof(ShmRingHeader);
+    }
+
+    /**
+     * Use a ring laid out by Create(), possibly in another process
+     * @param base Address of the ring in this process
+     */
+    void Attach(void *base)
+    {
+        m_header = static_cast<ShmRingHeader *>(base);
+        m_slots = static_cast<char *>(base) + sizeof(ShmRingHeader);
+    }
+
+    /// @return Bytes per record
+    uint32_t GetRecordSize() const
+    {
+        return m_header->recordSize;
+    }
+
+    /// @return Number of slots
+    uint32_t GetCapacity() const
+    {
+        return m_header->capacity;
+    }
+
+    /**
+     * @param position Slot position (any value, wrapped to the ring)
+     * @return Address of the slot
+     */
+    void *Slot(uint64_t position) const
+    {
+        return m_slots + (position & (m_header->capacity - 1)) * m_header->recordSize;
+    }
+
+    /**
+     * Writer: reserve the next n slots, waiting while reader 0 is a whole ring behind
+     * @param n Number of slots (at most the capacity)
+     * @param start Set to the position of the first reserved slot
+     * @return false if the ring has been closed or reader 0 has exited while
+     *         attached (see IsReaderAlive())
+     */
+    bool Reserve(uint32_t n, uint64_t &start)
+    {
+        start = m_header->reserved.position.load(std::memory_order_relaxed);
+        RingCounter &consumer = m_header->tails[0];
+        auto nextCheck = std::chrono::steady_clock::now() + WIFI_RING_LIVENESS_PERIOD;
+        while (consumer.attached.load(std::memory_order_acquire) &&
+               start + n - consumer.position.load(std::memory_order_acquire) > GetCapacity())
+        {
+            if (IsClosed() || !CheckConsumer(nextCheck))
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        // Observers compare against reserved after reading, so it must be visible before
+        // the slots are overwritten (seqlock-style write order)
+        m_header->reserved.position.store(start + n, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return !IsClosed();
+    }
+
+    /// Writer: make every reserved slot readable
+    void Publish()
+    {
+        m_header->published.position.store(
+            m_header->reserved.position.load(std::memory_order_relaxed),
+            std::memory_order_release);
+    }
+
+    /// Shut the ring down: no further record is published, a waiting writer gives up
+    void Close()
+    {
+        m_header->closed.store(1, std::memory_order_release);
+    }
+
+    /// @return true once the ring has been shut down
+    bool IsClosed() const
+    {
+        return m_header->closed.load(std::memory_order_acquire) != 0;
+    }
+
+    /**
+     * Reader: take a cursor
+     * Reader 0 starts at the oldest record still in the ring, observers at the newest.
+     * @param reader Cursor index (below WIFI_RING_MAX_READERS)
+     */
+    void AttachReader(uint32_t reader)
+    {
+        uint64_t published = m_header->published.position.load(std::memory_order_acquire);
+        uint64_t start = published;
+        if (reader == 0)
+        {
+            start = published > GetCapacity() ? published - GetCapacity() : 0;
+        }
+        m_header->tails[reader].position.store(start, std::memory_order_relaxed);
+        m_header->tails[reader].pid.store(getpid(), std::memory_order_relaxed);
+        m_header->tails[reader].attached.store(1, std::memory_order_release);
+    }
+
+    /**
+     * Reader: give up a cursor (the writer no longer waits for reader 0)
+     * @param reader Cursor index
+     */
+    void DetachReader(uint32_t reader)
+    {
+        m_header->tails[reader].attached.store(0, std::memory_order_release);
+    }
+
+    /**
+     * @param reader Cursor index
+     * @return false if the cursor is attached but the process that attached it has
+     *         exited, so nobody will release its slots any more
+     */
+    bool IsReaderAlive(uint32_t reader) const
+    {
+        const RingCounter &tail = m_header->tails[reader];
+        if (!tail.attached.load(std::memory_order_acquire))
+        {
+            return true;
+        }
+        pid_t pid = tail.pid.load(std::memory_order_relaxed);
+        return pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH;
+    }
+
+    /**
+     * Reader: ready slots, up to the end of the ring (call again for the rest)
+     * @param reader Cursor index
+     * @param maxRecords Most slots returned (0: no limit)
+     * @return Ready slots, count 0 if none; pass to Release() once read
+     */
+    RingSpan Poll(uint32_t reader, uint32_t maxRecords = 0)
+    {
+        RingSpan span;
+        RingCounter &tail = m_header->tails[reader];
+        uint64_t published = m_header->published.position.load(std::memory_order_acquire);
+        span.start = tail.position.load(std::memory_order_relaxed);
+        if (published - span.start > GetCapacity())
+        {
+            // Lapped observer: the oldest slots have been reused, continue with the oldest left
+            span.skipped = published - GetCapacity() - span.start;
+            span.start = published - GetCapacity();
+            tail.position.store(span.start, std::memory_order_release);
+        }
+        uint64_t ready = published - span.start;
+        uint64_t toEnd = GetCapacity() - (span.start & (GetCapacity() - 1));
+        span.count = static_cast<uint32_t>(std::min(ready, toEnd));
+        if (maxRecords != 0)
+        {
+            span.count = std::min(span.count, maxRecords);
+        }
+        return span;
+    }
+
+    /**
+     * Reader: hand the slots of a span back to the writer
+     * @param reader Cursor index
+     * @param span Span returned by Poll(), fully read
+     * @return false if the writer may have overwritten a slot while it was read
+     *         (observers only; the data read from the span is then unreliable)
+     */
+    bool Release(uint32_t reader, const RingSpan &span)
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t reserved = m_header->reserved.position.load(std::memory_order_relaxed);
+        m_header->tails[reader].position.store(span.start + span.count,
+                                               std::memory_order_release);
+        return reserved <= span.start + GetCapacity();
+    }
+
+    /**
+     * @param reader Cursor index
+     * @return Published slots the reader has not released yet
+     */
+    uint64_t GetPending(uint32_t reader) const
+    {
+        return m_header->published.position.load(std::memory_order_acquire) -
+               m_header->tails[reader].position.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Writer: wait until reader 0 has released every published slot or detached
+     * (observers are not waited for)
+     * @return false if reader 0 has exited while attached, with slots left unread
+     */
+    bool WaitConsumed() const
+    {
+        auto nextCheck = std::chrono::steady_clock::now() + WIFI_RING_LIVENESS_PERIOD;
+        while (m_header->tails[0].attached.load(std::memory_order_acquire) && GetPending(0) > 0)
+        {
+            if (!CheckConsumer(nextCheck))
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+  private:
+    /**
+     * Writer waiting for reader 0: check that its process still runs, at most once per
+     * WIFI_RING_LIVENESS_PERIOD (a check is a system call)
+     * @param nextCheck Time of the next check, advanced after each check
+     * @return false once reader 0 has exited while attached
+     */
+    bool CheckConsumer(std::chrono::steady_clock::time_point &nextCheck) const
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (now < nextCheck)
+        {
+            return true;
+        }
+        nextCheck = now + WIFI_RING_LIVENESS_PERIOD;
+        return IsReaderAlive(0);
+    }
+
+    ShmRingHeader *m_header = nullptr; ///< Control block
+    char *m_slots = nullptr;           ///< First slot
+};
+
+/**
+ * @struct ShmSegmentHeader
+ * @brief Layout of a ring segment, at its start
+ */
+struct ShmSegmentHeader
+{
+    std::atomic<uint64_t> magic; ///< WIFI_RING_MAGIC once the rings are laid out
+    uint32_t version;            ///< WIFI_RING_VERSION of the creator
+    uint32_t reserved;           ///< Unused
+    uint64_t size;               ///< Bytes of the segment
+    uint64_t telemetryOffset;    ///< Offset of the telemetry ring (C++ to Python)
+    uint64_t actionOffset;       ///< Offset of the action ring (Python to C++)
+};
+
+/**
+ * @class ShmRingSegment
+ * @brief POSIX shared-memory segment holding a telemetry and an action ring
+ *
+ * The creator unlinks the segment when it is closed; processes that still map
+ * it keep their mapping.
+ */
+class ShmRingSegment
+{
+  public:
+    ShmRingSegment() = default;
+    ShmRingSegment(const ShmRingSegment &) = delete;
+    ShmRingSegment &operator=(const ShmRingSegment &) = delete;
+
+    ~ShmRingSegment()
+    {
+        Close();
+    }
+
+    /**
+     * Create (or replace) the segment and lay out both rings
+     * @param name POSIX shared-memory name ("/name")
+     * @param telemetrySize Bytes per telemetry record
+     * @param telemetrySlots Slots of the telemetry ring (a power of two)
+     * @param actionSize Bytes per action record
+     * @param actionSlots Slots of the action ring (a power of two)
+     * @return false if the segment cannot be created or mapped
+     */
+    bool Create(const std::string &name,
+                uint32_t telemetrySize,
+                uint32_t telemetrySlots,
+                uint32_t actionSize,
+                uint32_t actionSlots)
+    {
+        shm_unlink(name.c_str()); // Left over by a crashed run
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+        {
+            return false;
+        }
+        uint64_t telemetryOffset = AlignUp(sizeof(ShmSegmentHeader));
+        uint64_t actionOffset =
+            telemetryOffset + AlignUp(ShmRing::GetBytes(telemetrySize, telemetrySlots));
+        uint64_t size = actionOffset + AlignUp(ShmRing::GetBytes(actionSize, actionSlots));
+        bool mapped = ftruncate(fd, size) == 0 && Map(fd, size);
+        close(fd);
+        if (!mapped)
+        {
+            shm_unlink(name.c_str());
+            return false;
+        }
+        m_name = name;
+        m_creator = true;
+
+        auto header = new (m_base) ShmSegmentHeader();
+        header->version = WIFI_RING_VERSION;
+        header->size = size;
+        header->telemetryOffset = telemetryOffset;
+        header->actionOffset = actionOffset;
+        m_telemetry.Create(static_cast<char *>(m_base) + telemetryOffset,
+                           telemetrySize,
+                           telemetrySlots);
+        m_actions.Create(static_cast<char *>(m_base) + actionOffset, actionSize, actionSlots);
+        header->magic.store(WIFI_RING_MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Map a segment created by another process
+     * @param name POSIX shared-memory name ("/name")
+     * @return false if the segment does not exist (yet), is not laid out yet or
+     *         has another layout version
+     */
+    bool Open(const std::string &name)
+    {
+        int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat st;
+        bool mapped = fstat(fd, &st) == 0 &&
+                      static_cast<std::size_t>(st.st_size) >= sizeof(ShmSegmentHeader) &&
+                      Map(fd, st.st_size);
+        close(fd);
+        if (!mapped)
+        {
+            return false;
+        }
+        auto header = static_cast<ShmSegmentHeader *>(m_base);
+        if (header->magic.load(std::memory_order_acquire) != WIFI_RING_MAGIC ||
+            header->version != WIFI_RING_VERSION || header->size > m_size)
+        {
+            Close();
+            return false;
+        }
+        m_telemetry.Attach(static_cast<char *>(m_base) + header->telemetryOffset);
+        m_actions.Attach(static_cast<char *>(m_base) + header->actionOffset);
+        return true;
+    }
+
+    /// Unmap the segment (and unlink it if this process created it)
+    void Close()
+    {
+        if (m_base)
+        {
+            munmap(m_base, m_size);
+            m_base = nullptr;
+        }
+        if (m_creator)
+        {
+            shm_unlink(m_name.c_str());
+            m_creator = false;
+        }
+    }
+
+    /// @return true while the segment is mapped
+    bool IsOpen() const
+    {
+        return m_base != nullptr;
+    }
+
+    /// @return Ring of telemetry records (written by C++)
+    ShmRing &Telemetry()
+    {
+        return m_telemetry;
+    }
+
+    /// @return Ring of actions (written by Python)
+    ShmRing &Actions()
+    {
+        return m_actions;
+    }
+
+  private:
+    /// @return bytes rounded up to whole cache lines
+    static uint64_t AlignUp(uint64_t bytes)
+    {
+        return (bytes + WIFI_CACHE_LINE - 1) / WIFI_CACHE_LINE * WIFI_CACHE_LINE;
+    }
+
+    /// Map size bytes of fd read-write; @return false on failure
+    bool Map(int fd, std::size_t size)
+    {
+        void *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED)
+        {
+            return false;
+        }
+        m_base = base;
+        m_size = size;
+        return true;
+    }
+
+    std::string m_name;     ///< Segment name (creator only)
+    bool m_creator = false; ///< This process created (and unlinks) the segment
+    void *m_base = nullptr; ///< Mapping of the segment
+    std::size_t m_size = 0; ///< Bytes mapped
+    ShmRing m_telemetry;    ///< C++ to Python records
+    ShmRing m_actions;      ///< Python to C++ records
+};
+
+#endif // WIFI_SHM_RING_H
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2025 Texas State University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+ * PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+ * Texas State University
+ */
+
+/**
+ * @file wifi_telemetry_log.h
+ * @brief Append-only binary columnar log of per-STA report records
+ *
+ * Used by the telemetry-only mode of the WiFi simulation, where no Python
+ * peer is running. Each record holds the EnvStruct fields plus the AP Tx
+ * power chosen for the report (set_ApTx), i.e. one row of toy_data.csv.
+ *
+ * File layout (native byte order):
+ * - TelemetryLogHeader
+ * - column_count x TelemetryLogColumn descriptors
+ * - Blocks, one per report: uint32_t record count, then each column's
+ *   values stored contiguously in descriptor order
+ *
+ * wifi_telemetry_log.py reads this format back into a pandas DataFrame.
+ */
+
+#ifndef WIFI_TELEMETRY_LOG_H
+#define WIFI_TELEMETRY_LOG_H
+
+#include "wifi_data_structures.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/// Magic bytes at the start of every telemetry log
+constexpr char WIFI_TELEMETRY_MAGIC[8] = {'W', 'I', 'F', 'I', 'T', 'L', 'M', '\0'};
+
+/// Version of the telemetry log layout (2: ap_id, 3: flow statistics, 4: PHY counters)
+constexpr uint16_t WIFI_TELEMETRY_VERSION = 4;
+
+/// Column value types of the telemetry log
+enum TelemetryColumnType : uint8_t
+{
+    TELEMETRY_FLOAT64 = 0, ///< 8-byte IEEE double
+    TELEMETRY_INT32 = 1,   ///< 4-byte signed integer
+};
+
+/**
+ * @struct TelemetryLogHeader
+ * @brief Fixed header at the start of a telemetry log
+ */
+struct TelemetryLogHeader
+{
+    char magic[8];         ///< WIFI_TELEMETRY_MAGIC
+    uint16_t version;      ///< WIFI_TELEMETRY_VERSION
+    uint16_t column_count; ///< Number of TelemetryLogColumn descriptors that follow
+    uint32_t n_stas;       ///< Number of STAs in the scenario (records per full report)
+};
+
+/**
+ * @struct TelemetryLogColumn
+ * @brief Name and value type of one telemetry column
+ */
+struct TelemetryLogColumn
+{
+    char name[15]; ///< NUL-padded column name (matches the toy_data.csv header)
+    uint8_t type;  ///< TelemetryColumnType
+};
+
+/**
+ * @class TelemetryLogWriter
+ * @brief Buffers the records of one report column by column and appends them as a block
+ */
+class TelemetryLogWriter
+{
+  public:
+    /**
+     * Create the log file and write its header
+     * @param path Output file path
+     * @param nStas Number of STAs in the scenario
+     * @return false if the file could not be written
+     */
+    bool Open(const std::string &path, uint32_t nStas)
+    {
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file)
+        {
+            return false;
+        }
+
+        TelemetryLogHeader header{};
+        std::memcpy(header.magic, WIFI_TELEMETRY_MAGIC, sizeof(header.magic));
+        header.version = WIFI_TELEMETRY_VERSION;
+        header.column_count = COLUMN_COUNT;
+        header.n_stas = nStas;
+        m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        const char *names[COLUMN_COUNT] = {"pos_x",
+                                           "pos_y",
+                                           "distance",
+                                           "dl_tp",
+                                           "ul_tp",
+                                           "get_ApTx",
+                                           "sta_id",
+                                           "ap_id",
+                                           "now_sec",
+                                           "set_ApTx",
+                                           "dl_delay",
+                                           "dl_jitter",
+                                           "dl_loss",
+                                           "ul_delay",
+                                           "ul_jitter",
+                                           "ul_loss",
+                                           "rx_frames",
+                                           "rx_drops",
+                                           "tx_drops",
+                                           "ap_rx_drops",
+                                           "rssi",
+                                           "snr"};
+        for (uint16_t c = 0; c < COLUMN_COUNT; ++c)
+        {
+            TelemetryLogColumn column{};
+            std::strncpy(column.name, names[c], sizeof(column.name) - 1);
+            column.type = IsIntColumn(c) ? TELEMETRY_INT32 : TELEMETRY_FLOAT64;
+            m_file.write(reinterpret_cast<const char *>(&column), sizeof(column));
+        }
+        return static_cast<bool>(m_file);
+    }
+
+    /**
+     * Buffer one STA record of the current report
+     * @param env Record as it would be sent to Python
+     * @param setApTx AP Tx power chosen for this report
+     */
+    void Append(const EnvStruct &env, double setApTx)
+    {
+        m_float[0].push_back(env.env_pos_x);
+        m_float[1].push_back(env.env_pos_y);
+        m_float[2].push_back(env.env_distance);
+        m_float[3].push_back(env.env_dl_tp);
+        m_float[4].push_back(env.env_ul_tp);
+        m_float[5].push_back(env.env_get_ApTx);
+        m_int[0].push_back(env.env_sta_id);
+        m_int[1].push_back(env.env_ap_id);
+        m_float[6].push_back(env.env_now_sec);
+        m_float[7].push_back(setApTx);
+        m_float[8].push_back(env.env_dl_delay);
+        m_float[9].push_back(env.env_dl_jitter);
+        m_float[10].push_back(env.env_dl_loss);
+        m_float[11].push_back(env.env_ul_delay);
+        m_float[12].push_back(env.env_ul_jitter);
+        m_float[13].push_back(env.env_ul_loss);
+        m_int[2].push_back(env.env_rx_frames);
+        m_int[3].push_back(env.env_rx_drops);
+        m_int[4].push_back(env.env_tx_drops);
+        m_int[5].push_back(env.env_ap_rx_drops);
+        m_float[14].push_back(env.env_rssi);
+        m_float[15].push_back(env.env_snr);
+    }
+
+    /**
+     * Append the buffered records as one block
+     * @return false if the block could not be written
+     */
+    bool Flush()
+    {
+        uint32_t count = m_int[0].size();
+        if (count == 0)
+        {
+            return true;
+        }
+        m_file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        for (uint16_t c = 0, f = 0, i = 0; c < COLUMN_COUNT; ++c)
+        {
+            if (IsIntColumn(c))
+            {
+                m_file.write(reinterpret_cast<const char *>(m_int[i].data()),
+                             count * sizeof(int32_t));
+                m_int[i++].clear();
+            }
+            else
+            {
+                m_file.write(reinterpret_cast<const char *>(m_float[f].data()),
+                             count * sizeof(double));
+                m_float[f++].clear();
+            }
+        }
+        return static_cast<bool>(m_file);
+    }
+
+    /// Flush pending records and close the file
+    void Close()
+    {
+        if (m_file.is_open())
+        {
+            Flush();
+            m_file.close();
+        }
+    }
+
+  private:
+    static constexpr uint16_t COLUMN_COUNT = 22; ///< Columns per record
+    static constexpr uint16_t INT_COLUMNS = 6;   ///< int32 columns: ids and PHY counters
+
+    /// @return Whether column c holds int32 values (sta_id, ap_id and the PHY frame counts)
+    static bool IsIntColumn(uint16_t c)
+    {
+        return c == 6 || c == 7 || (c >= 16 && c <= 19);
+    }
+
+    std::ofstream m_file;                                    ///< Output file
+    std::vector<double> m_float[COLUMN_COUNT - INT_COLUMNS]; ///< Buffered float64 columns
+    std::vector<int32_t> m_int[INT_COLUMNS];                 ///< Buffered int32 columns
+};
+
+#endif // WIFI_TELEMETRY_LOG_H
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Texas State University
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+# Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+# PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+# Texas State University
+
+"""
+WiFi Network Simulation - Telemetry Log Reader
+
+Reads the binary columnar log written by the telemetry-only mode of
+wifi_network_simulation.cc (--ipcMode=none, see wifi_telemetry_log.h):
+- Validates the header (magic, version, column descriptors)
+- Reads the report blocks sequentially as NumPy columns, seeking over the
+  columns that were not requested
+- Returns a pandas DataFrame with the same columns as toy_data.csv
+
+Usage as a script converts a log to CSV for wifi_network_visualization.py, or
+streams it to Parquet / Arrow IPC (by output extension, see wifi_recorder.py):
+    python3 wifi_telemetry_log.py wifi_telemetry.bin -o toy_data.csv
+    python3 wifi_telemetry_log.py wifi_telemetry.bin -o toy_data.parquet
+"""
+
+import argparse
+import struct
+
+import numpy as np
+import pandas as pd
+
+# Layout constants (must match wifi_telemetry_log.h)
+TELEMETRY_MAGIC = b"WIFITLM\0"
+# 2 added the ap_id column, 3 the flow statistics, 4 the PHY counters; the reader
+# follows the descriptors
+TELEMETRY_VERSIONS = (1, 2, 3, 4)
+HEADER = struct.Struct("=8sHHI")  # magic, version, column_count, n_stas
+COLUMN = struct.Struct("=15sB")  # name, type
+BLOCK_COUNT = struct.Struct("=I")  # records in the block
+COLUMN_TYPES = {0: np.float64, 1: np.int32}
+
+
+def read_telemetry_header(f, path):
+    """Validate the header of an open telemetry log; return its (name, dtype) columns"""
+    magic, version, column_count, _n_stas = HEADER.unpack(f.read(HEADER.size))
+    if magic != TELEMETRY_MAGIC:
+        raise ValueError(f"{path}: not a WiFi telemetry log")
+    if version not in TELEMETRY_VERSIONS:
+        raise ValueError(f"{path}: unsupported telemetry log version {version}")
+    columns = []
+    for _ in range(column_count):
+        name, type_id = COLUMN.unpack(f.read(COLUMN.size))
+        columns.append((name.rstrip(b"\0").decode(), np.dtype(COLUMN_TYPES[type_id])))
+    return columns
+
+
+def iter_telemetry_blocks(f, layout, columns=None):
+    """
+    Yield one {name: NumPy array} dict per report block, reading f sequentially
+    layout: (name, dtype) columns returned by read_telemetry_header
+    columns: names of the columns to decode (None: all); the others are skipped with
+             a seek, so they are never read
+    """
+    while True:
+        header = f.read(BLOCK_COUNT.size)
+        if len(header) < BLOCK_COUNT.size:
+            return
+        (count,) = BLOCK_COUNT.unpack(header)
+        block = {}
+        for name, dtype in layout:
+            if columns is None or name in columns:
+                block[name] = np.frombuffer(f.read(count * dtype.itemsize), dtype=dtype)
+            else:
+                f.seek(count * dtype.itemsize, 1)
+        yield block
+
+
+def read_telemetry_log(path, columns=None):
+    """
+    Load a telemetry log into a DataFrame (one row per STA record)
+    columns: names of the columns to load (None: all)
+    """
+    with open(path, "rb") as f:
+        layout = read_telemetry_header(f, path)
+        if columns is not None:
+            missing = set(columns) - {name for name, _ in layout}
+            if missing:
+                raise ValueError(f"{path}: no column(s) {sorted(missing)}")
+        selected = [(name, dtype) for name, dtype in layout if columns is None or name in columns]
+        parts = {name: [] for name, _ in selected}
+        for block in iter_telemetry_blocks(f, layout, columns):
+            for name, _ in selected:
+                parts[name].append(block[name])
+
+    return pd.DataFrame(
+        {
+            name: np.concatenate(parts[name]) if parts[name] else np.empty(0, dtype)
+            for name, dtype in selected
+        }
+    )
+
+
+def convert_telemetry_log(path, output, rows_per_group=65536):
+    """
+    Stream a telemetry log into a CSV, Parquet or Arrow IPC file (by extension),
+    about rows_per_group records at a time, so memory stays bounded for any log size
+    """
+    from wifi_recorder import open_sink
+
+    with open(path, "rb") as f:
+        layout = read_telemetry_header(f, path)
+        dtype = np.dtype(layout)
+        sink = open_sink(output, dtype)
+        pending = []
+        total = 0
+
+        def write_pending():
+            rows = np.empty(sum(len(block[layout[0][0]]) for block in pending), dtype=dtype)
+            for name, _ in layout:
+                rows[name] = np.concatenate([block[name] for block in pending])
+            sink.write(rows)
+            pending.clear()
+            return len(rows)
+
+        pending_rows = 0
+        for block in iter_telemetry_blocks(f, layout):
+            pending.append(block)
+            pending_rows += len(block[layout[0][0]])
+            if pending_rows >= rows_per_group:
+                total += write_pending()
+                pending_rows = 0
+        if pending:
+            total += write_pending()
+        sink.close()
+    return total
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Convert a WiFi telemetry log to CSV, Parquet or Arrow IPC"
+    )
+    parser.add_argument("log", help="telemetry log written with --ipcMode=none")
+    parser.add_argument(
+        "-o",
+        "--output",
+        default="toy_data.csv",
+        help="output path; .parquet and .arrow select those formats (default: toy_data.csv)",
+    )
+    parser.add_argument(
+        "--rows-per-group",
+        type=int,
+        default=65536,
+        help="records converted (and written as one Parquet row group) at a time",
+    )
+    args = parser.parse_args()
+
+    count = convert_telemetry_log(args.log, args.output, args.rows_per_group)
+    print(f"Converted {count} records from {args.log} to {args.output}")
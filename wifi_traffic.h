@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2025 Texas State University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+ * PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+ * Texas State University
+ */
+
+/**
+ * @file wifi_traffic.h
+ * @brief Traffic sources and the shared sink of the lean scenario
+ *
+ * ns-3 has constant-interval (UdpClient) and on/off (OnOffApplication)
+ * sources but no Poisson one: PoissonUdpClient sends fixed-size UDP packets
+ * with exponentially distributed gaps, so the offered load matches a CBR
+ * client with the same mean interval. Receivers need no sequence header, any
+ * UDP sink (PacketSink) counts the bytes.
+ *
+ * The lean scenario (lean=true) trades the per-flow applications for two
+ * compact ones:
+ * - MultiPeerSource: one application and one socket per node, sending to
+ *   each of its peers in turn at the per-flow load of a UdpClient
+ * - SharedByteSink: one object for the whole run, a receive-only socket on
+ *   every node and one byte counter per socket instead of a PacketSink each
+ * Both work with UDP and with packet sockets (no IP stack).
+ */
+
+#ifndef WIFI_TRAFFIC_H
+#define WIFI_TRAFFIC_H
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/boolean.h"
+#include "ns3/callback.h"
+#include "ns3/double.h"
+#include "ns3/event-id.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/type-id.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class PoissonUdpClient
+ * @brief Sends PacketSize-byte UDP packets to RemoteAddress with exponential gaps
+ */
+class PoissonUdpClient : public ns3::Application
+{
+  public:
+    static ns3::TypeId GetTypeId()
+    {
+        static ns3::TypeId tid =
+            ns3::TypeId("ns3::PoissonUdpClient")
+                .SetParent<ns3::Application>()
+                .SetGroupName("Applications")
+                .AddConstructor<PoissonUdpClient>()
+                .AddAttribute("RemoteAddress",
+                              "Destination address and port (InetSocketAddress)",
+                              ns3::AddressValue(),
+                              ns3::MakeAddressAccessor(&PoissonUdpClient::m_peer),
+                              ns3::MakeAddressChecker())
+                .AddAttribute("PacketSize",
+                              "UDP payload size of every packet (bytes)",
+                              ns3::UintegerValue(1472),
+                              ns3::MakeUintegerAccessor(&PoissonUdpClient::m_size),
+                              ns3::MakeUintegerChecker<uint32_t>(1))
+                .AddAttribute("MeanInterval",
+                              "Mean time between two packets",
+                              ns3::TimeValue(ns3::MilliSeconds(1)),
+                              ns3::MakeTimeAccessor(&PoissonUdpClient::m_meanInterval),
+                              ns3::MakeTimeChecker());
+        return tid;
+    }
+
+    PoissonUdpClient()
+        : m_gap(ns3::CreateObject<ns3::ExponentialRandomVariable>())
+    {
+    }
+
+    int64_t AssignStreams(int64_t stream) override
+    {
+        m_gap->SetStream(stream);
+        return 1;
+    }
+
+    /// @return Number of packets sent
+    uint64_t GetSent() const
+    {
+        return m_sent;
+    }
+
+  private:
+    void StartApplication() override
+    {
+        if (!m_socket)
+        {
+            m_socket = ns3::Socket::CreateSocket(GetNode(), ns3::UdpSocketFactory::GetTypeId());
+            m_socket->Bind();
+            m_socket->Connect(m_peer);
+        }
+        m_gap->SetAttribute("Mean", ns3::DoubleValue(m_meanInterval.GetSeconds()));
+        ScheduleNext();
+    }
+
+    void StopApplication() override
+    {
+        ns3::Simulator::Cancel(m_sendEvent);
+        if (m_socket)
+        {
+            m_socket->Close();
+        }
+    }
+
+    /// Schedule the next packet after an exponential gap
+    void ScheduleNext()
+    {
+        m_sendEvent = ns3::Simulator::Schedule(ns3::Seconds(m_gap->GetValue()),
+                                               &PoissonUdpClient::Send,
+                                               this);
+    }
+
+    /// Send one packet and schedule the next one
+    void Send()
+    {
+        m_socket->Send(ns3::Create<ns3::Packet>(m_size));
+        ++m_sent;
+        ScheduleNext();
+    }
+
+    ns3::Address m_peer;                            ///< Destination address
+    uint32_t m_size = 1472;                         ///< Packet size (bytes)
+    ns3::Time m_meanInterval;                       ///< Mean packet gap
+    ns3::Ptr<ns3::ExponentialRandomVariable> m_gap; ///< Gap distribution (s)
+    ns3::Ptr<ns3::Socket> m_socket;                 ///< UDP socket
+    ns3::EventId m_sendEvent;                       ///< Next send
+    uint64_t m_sent = 0;                            ///< Packets sent
+};
+
+/**
+ * @class MultiPeerSource
+ * @brief Sends PacketSize-byte packets to each of its peers in turn from a single socket
+ *
+ * Every peer gets one packet per Interval on average, the load of one
+ * UdpClient (or PoissonUdpClient with Poisson=true) per peer.
+ */
+class MultiPeerSource : public ns3::Application
+{
+  public:
+    static ns3::TypeId GetTypeId()
+    {
+        static ns3::TypeId tid =
+            ns3::TypeId("ns3::MultiPeerSource")
+                .SetParent<ns3::Application>()
+                .SetGroupName("Applications")
+                .AddConstructor<MultiPeerSource>()
+                .AddAttribute("SocketFactory",
+                              "Socket type (UdpSocketFactory or PacketSocketFactory)",
+                              ns3::TypeIdValue(ns3::UdpSocketFactory::GetTypeId()),
+                              ns3::MakeTypeIdAccessor(&MultiPeerSource::m_factory),
+                              ns3::MakeTypeIdChecker())
+                .AddAttribute("PacketSize",
+                              "Payload size of every packet (bytes)",
+                              ns3::UintegerValue(1472),
+                              ns3::MakeUintegerAccessor(&MultiPeerSource::m_size),
+                              ns3::MakeUintegerChecker<uint32_t>(1))
+                .AddAttribute("Interval",
+                              "(Mean) time between two packets to the same peer",
+                              ns3::TimeValue(ns3::MilliSeconds(1)),
+                              ns3::MakeTimeAccessor(&MultiPeerSource::m_interval),
+                              ns3::MakeTimeChecker())
+                .AddAttribute("Poisson",
+                              "Exponential gaps instead of constant ones",
+                              ns3::BooleanValue(false),
+                              ns3::MakeBooleanAccessor(&MultiPeerSource::m_poisson),
+                              ns3::MakeBooleanChecker());
+        return tid;
+    }
+
+    MultiPeerSource()
+        : m_gap(ns3::CreateObject<ns3::ExponentialRandomVariable>())
+    {
+    }
+
+    /// @param peer Destination (InetSocketAddress or PacketSocketAddress), added before Start
+    void AddPeer(const ns3::Address &peer)
+    {
+        m_peers.push_back(peer);
+    }
+
+    int64_t AssignStreams(int64_t stream) override
+    {
+        m_gap->SetStream(stream);
+        return 1;
+    }
+
+  private:
+    void StartApplication() override
+    {
+        if (m_peers.empty())
+        {
+            return;
+        }
+        if (!m_socket)
+        {
+            m_socket = ns3::Socket::CreateSocket(GetNode(), m_factory);
+            m_socket->Bind();
+            m_socket->ShutdownRecv(); // Send-only: nothing is queued for reading
+        }
+        // The peers share the node's load, so the gap between any two packets is Interval / n
+        m_gap->SetAttribute("Mean", ns3::DoubleValue(m_interval.GetSeconds() / m_peers.size()));
+        ScheduleNext();
+    }
+
+    void StopApplication() override
+    {
+        ns3::Simulator::Cancel(m_sendEvent);
+        if (m_socket)
+        {
+            m_socket->Close();
+        }
+    }
+
+    /// Schedule the next packet after a constant or exponential gap
+    void ScheduleNext()
+    {
+        double gap = m_poisson ? m_gap->GetValue() : m_interval.GetSeconds() / m_peers.size();
+        m_sendEvent = ns3::Simulator::Schedule(ns3::Seconds(gap), &MultiPeerSource::Send, this);
+    }
+
+    /// Send one packet to the next peer and schedule the next one
+    void Send()
+    {
+        m_socket->SendTo(ns3::Create<ns3::Packet>(m_size), 0, m_peers[m_next]);
+        m_next = (m_next + 1) % m_peers.size();
+        ScheduleNext();
+    }
+
+    ns3::TypeId m_factory;                          ///< Socket factory
+    uint32_t m_size = 1472;                         ///< Packet size (bytes)
+    ns3::Time m_interval;                           ///< (Mean) packet gap per peer
+    bool m_poisson = false;                         ///< Exponential gaps
+    std::vector<ns3::Address> m_peers;              ///< Destinations, served in turn
+    uint32_t m_next = 0;                            ///< Index of the next destination
+    ns3::Ptr<ns3::ExponentialRandomVariable> m_gap; ///< Gap distribution (s)
+    ns3::Ptr<ns3::Socket> m_socket;                 ///< Send-only socket
+    ns3::EventId m_sendEvent;                       ///< Next send
+};
+
+/**
+ * @class SharedByteSink
+ * @brief Receive-only sockets on many nodes, one received-byte counter per socket
+ *
+ * Stands in for one PacketSink application per node: a received packet is
+ * counted against its socket's slot and freed right away.
+ */
+class SharedByteSink : public ns3::Object
+{
+  public:
+    static ns3::TypeId GetTypeId()
+    {
+        static ns3::TypeId tid = ns3::TypeId("ns3::SharedByteSink")
+                                     .SetParent<ns3::Object>()
+                                     .SetGroupName("Applications")
+                                     .AddConstructor<SharedByteSink>();
+        return tid;
+    }
+
+    /**
+     * Open a receiving socket on a node
+     * @param node Node of the socket
+     * @param factory Socket type (UdpSocketFactory or PacketSocketFactory)
+     * @param local Address the socket is bound to (port or device and protocol)
+     * @return Slot of the socket's byte counter (slots are numbered in call order)
+     */
+    uint32_t Listen(ns3::Ptr<ns3::Node> node, ns3::TypeId factory, const ns3::Address &local)
+    {
+        uint32_t slot = m_rx.size();
+        ns3::Ptr<ns3::Socket> socket = ns3::Socket::CreateSocket(node, factory);
+        socket->Bind(local);
+        socket->SetRecvCallback(ns3::MakeBoundCallback(&SharedByteSink::Receive, this, slot));
+        m_sockets.push_back(socket);
+        m_rx.push_back(0);
+        return slot;
+    }
+
+    /// @return Bytes received so far by the socket of a slot
+    uint64_t GetRx(uint32_t slot) const
+    {
+        return m_rx[slot];
+    }
+
+  private:
+    /// Count and drop every packet waiting on a socket
+    static void Receive(SharedByteSink *sink, uint32_t slot, ns3::Ptr<ns3::Socket> socket)
+    {
+        while (ns3::Ptr<ns3::Packet> packet = socket->Recv())
+        {
+            sink->m_rx[slot] += packet->GetSize();
+        }
+    }
+
+    void DoDispose() override
+    {
+        for (ns3::Ptr<ns3::Socket> &socket : m_sockets)
+        {
+            socket->Close();
+        }
+        m_sockets.clear();
+        ns3::Object::DoDispose();
+    }
+
+    std::vector<ns3::Ptr<ns3::Socket>> m_sockets; ///< Receiving socket of every slot
+    std::vector<uint64_t> m_rx;                   ///< Received bytes of every slot
+};
+
+#endif // WIFI_TRAFFIC_H
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2025 Texas State University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ahmed Maksud <ahmed.maksud@email.ucr.edu>
+ * PI: Marcelo Menezes De Carvalho <mmcarvalho@txstate.edu>
+ * Texas State University
+ */
+
+/**
+ * @file wifi_tx_power_controller.h
+ * @brief Native (C++) AP transmission power controllers
+ *
+ * Controllers make the per-report AP Tx power decision inside the simulation,
+ * without a round trip to Python. Python remains the place for policies that
+ * need ML; the built-in controllers cover the simple rules:
+ * - linear: C++ port of adaptive_ap_tx() in wifi_analysis_and_control.py
+ * - hysteresis: linear rule that only moves when the target leaves a dead band
+ * - pid: PID loop driving the mean DL throughput towards a setpoint
+ *
+ * Call sequence per report (same timing as the Python rule):
+ * 1. Decide() returns the Tx power for the report being produced, based on
+ *    the reports observed so far
+ * 2. Observe() feeds the measurements of that report once it is complete
+ */
+
+#ifndef WIFI_TX_POWER_CONTROLLER_H
+#define WIFI_TX_POWER_CONTROLLER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+/**
+ * @struct TxPowerReport
+ * @brief Per-report measurements fed to a TxPowerController
+ */
+struct TxPowerReport
+{
+    double now_sec;      ///< Simulation time of the report in seconds
+    double tx_power_dbm; ///< AP Tx power in effect during the report (dBm)
+    double mean_dl_tp;   ///< Mean DL throughput over all STAs (Mbps)
+    double ul_tp;        ///< Total UL throughput at the AP (Mbps)
+    uint32_t n_stas;     ///< Number of STA records in the report
+};
+
+/**
+ * @struct TxPowerControllerConfig
+ * @brief Tunables of the built-in controllers
+ */
+struct TxPowerControllerConfig
+{
+    double min_dbm = 1.0;       ///< Lowest Tx power a controller may choose (dBm)
+    double max_dbm = 30.0;      ///< Highest Tx power a controller may choose (dBm)
+    double default_dbm = 20.0;  ///< Tx power before the first report is observed (dBm)
+    double ref_tp = 100.0;      ///< Linear: mean DL throughput mapped to the min power (Mbps)
+    double hysteresis_db = 2.0; ///< Hysteresis: dead band around the current power (dB)
+    double setpoint_tp = 1.0;   ///< PID: target mean DL throughput (Mbps)
+    double kp = 2.0;            ///< PID: proportional gain (dB per Mbps)
+    double ki = 0.5;            ///< PID: integral gain (dB per Mbps per report)
+    double kd = 0.0;            ///< PID: derivative gain (dB per Mbps change)
+};
+
+/**
+ * @class TxPowerController
+ * @brief Interface of a native AP Tx power policy
+ */
+class TxPowerController
+{
+  public:
+    virtual ~TxPowerController() = default;
+
+    /**
+     * Choose the AP Tx power for the report being produced
+     * @param currentDbm AP Tx power currently configured (dBm)
+     * @return New AP Tx power (dBm)
+     */
+    virtual double Decide(double currentDbm) = 0;
+
+    /**
+     * Feed the measurements of a completed report
+     * @param report Report measurements
+     */
+    virtual void Observe(const TxPowerReport &report) = 0;
+
+    /// @return Controller name as accepted by CreateTxPowerController()
+    virtual std::string GetName() const = 0;
+};
+
+/**
+ * @class LinearTxPowerController
+ * @brief Tx = clamp(max - max * meanDl / refTp) on the previous report (the Python rule)
+ */
+class LinearTxPowerController : public TxPowerController
+{
+  public:
+    explicit LinearTxPowerController(const TxPowerControllerConfig &config)
+        : m_config(config)
+    {
+    }
+
+    double Decide(double /* currentDbm */) override
+    {
+        return m_lastMeanDl ? Target(*m_lastMeanDl) : m_config.default_dbm;
+    }
+
+    void Observe(const TxPowerReport &report) override
+    {
+        m_lastMeanDl = report.mean_dl_tp;
+    }
+
+    std::string GetName() const override
+    {
+        return "linear";
+    }
+
+  protected:
+    /// Linear target power for a mean DL throughput
+    double Target(double meanDl) const
+    {
+        return std::clamp(m_config.max_dbm - m_config.max_dbm * meanDl / m_config.ref_tp,
+                          m_config.min_dbm,
+                          m_config.max_dbm);
+    }
+
+    TxPowerControllerConfig m_config;   ///< Controller tunables
+    std::optional<double> m_lastMeanDl; ///< Mean DL throughput of the last report (Mbps)
+};
+
+/**
+ * @class HysteresisTxPowerController
+ * @brief Linear rule that keeps the current power until the target leaves ±hysteresis_db
+ *
+ * Avoids toggling the AP power on every report when the throughput only
+ * fluctuates around its mean.
+ */
+class HysteresisTxPowerController : public LinearTxPowerController
+{
+  public:
+    explicit HysteresisTxPowerController(const TxPowerControllerConfig &config)
+        : LinearTxPowerController(config)
+    {
+    }
+
+    double Decide(double currentDbm) override
+    {
+        if (!m_lastMeanDl)
+        {
+            return m_config.default_dbm;
+        }
+        double target = Target(*m_lastMeanDl);
+        return std::abs(target - currentDbm) > m_config.hysteresis_db ? target : currentDbm;
+    }
+
+    std::string GetName() const override
+    {
+        return "hysteresis";
+    }
+};
+
+/**
+ * @class PidTxPowerController
+ * @brief PID loop on the mean DL throughput error (setpoint - measured)
+ *
+ * Raises the power when the STAs receive less than the setpoint and lowers it
+ * when they receive more. The integral term is frozen while the output is
+ * saturated (anti-windup).
+ */
+class PidTxPowerController : public TxPowerController
+{
+  public:
+    explicit PidTxPowerController(const TxPowerControllerConfig &config)
+        : m_config(config),
+          m_output(config.default_dbm)
+    {
+    }
+
+    double Decide(double /* currentDbm */) override
+    {
+        return m_output;
+    }
+
+    void Observe(const TxPowerReport &report) override
+    {
+        double error = m_config.setpoint_tp - report.mean_dl_tp;
+        double derivative = m_lastError ? error - *m_lastError : 0.0;
+        m_lastError = error;
+
+        double integral = m_integral + error;
+        double output = m_config.default_dbm + m_config.kp * error + m_config.ki * integral +
+                        m_config.kd * derivative;
+        m_output = std::clamp(output, m_config.min_dbm, m_config.max_dbm);
+        if (m_output == output)
+        {
+            m_integral = integral; // Only integrate while not saturated
+        }
+    }
+
+    std::string GetName() const override
+    {
+        return "pid";
+    }
+
+  private:
+    TxPowerControllerConfig m_config;  ///< Controller tunables
+    double m_output;                   ///< Tx power for the next report (dBm)
+    double m_integral = 0.0;           ///< Accumulated error (Mbps x reports)
+    std::optional<double> m_lastError; ///< Error of the previous report (Mbps)
+};
+
+/**
+ * Create a built-in controller by name
+ * @param name "linear", "hysteresis" or "pid"
+ * @param config Controller tunables
+ * @return The controller, or nullptr if the name is unknown
+ */
+inline std::unique_ptr<TxPowerController>
+CreateTxPowerController(const std::string &name, const TxPowerControllerConfig &config)
+{
+    if (name == "linear")
+    {
+        return std::make_unique<LinearTxPowerController>(config);
+    }
+    if (name == "hysteresis")
+    {
+        return std::make_unique<HysteresisTxPowerController>(config);
+    }
+    if (name == "pid")
+    {
+        return std::make_unique<PidTxPowerController>(config);
+    }
+    return nullptr;
+}
+
+#endif // WIFI_TX_POWER_CONTROLLER_H